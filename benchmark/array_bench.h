@@ -0,0 +1,168 @@
+#pragma once
+
+#include "benchmark.h"
+#include <numeric>
+#include <typeless.h>
+#include <vector>
+
+namespace array_bench {
+    using typeless::Array;
+
+    constexpr size_t N_ELEMENTS = 1 << 20;
+
+    template <class T>
+    const Array& source() {
+        static const Array arr = [] {
+            std::vector<T> v(N_ELEMENTS);
+            std::iota(v.begin(), v.end(), T{});
+            return Array(v.begin(), v.end());
+        }();
+        return arr;
+    }
+
+    /// \brief the element-by-element copy through helper calls that Array used before
+    template <class T>
+    void legacy_copy(const Array& src) {
+        const typeless::internal::ArrayHelper* helper = typeless::internal::GetArrayHelper<T>();
+        size_t n = src.size();
+        void* arr = helper->allocate(n);
+        const void* from = src.cbegin();
+        void* to = arr;
+        for (size_t i = 0; i < n; ++i) {
+            helper->construct(to, from);
+            from = helper->advance(from, 1);
+            to = helper->advance(to, 1);
+        }
+        bench::do_not_optimize(arr);
+        for (size_t i = 0; i < n; ++i) {
+            helper->destruct(helper->advance(arr, i));
+        }
+        helper->destroy_deallocate(arr, 0, n);
+    }
+
+    /// \brief the per-element copy of a default value that construct_default used before
+    template <class T>
+    void legacy_fill(size_t n) {
+        const typeless::internal::ArrayHelper* helper = typeless::internal::GetArrayHelper<T>();
+        void* arr = helper->allocate(n);
+        T default_value{};
+        for (size_t i = 0; i < n; ++i) {
+            helper->construct(helper->advance(arr, i), &default_value);
+        }
+        bench::do_not_optimize(arr);
+        for (size_t i = 0; i < n; ++i) {
+            helper->destruct(helper->advance(arr, i));
+        }
+        helper->destroy_deallocate(arr, 0, n);
+    }
+} // namespace array_bench
+
+BENCHMARK(ArrayCopy, LegacyInt) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] { array_bench::legacy_copy<int>(array_bench::source<int>()); });
+}
+
+BENCHMARK(ArrayCopy, Int) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] {
+        typeless::Array copy(array_bench::source<int>());
+        bench::do_not_optimize(copy);
+    });
+}
+
+BENCHMARK(ArrayCopy, LegacyDouble) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] { array_bench::legacy_copy<double>(array_bench::source<double>()); });
+}
+
+BENCHMARK(ArrayCopy, Double) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] {
+        typeless::Array copy(array_bench::source<double>());
+        bench::do_not_optimize(copy);
+    });
+}
+
+BENCHMARK(ArrayFill, LegacyInt) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] { array_bench::legacy_fill<int>(array_bench::N_ELEMENTS); });
+}
+
+BENCHMARK(ArrayFill, Int) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] {
+        typeless::Array arr;
+        arr.set_type<int>();
+        arr.resize(array_bench::N_ELEMENTS);
+        bench::do_not_optimize(arr);
+    });
+}
+
+BENCHMARK(ArrayFill, LegacyDouble) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] { array_bench::legacy_fill<double>(array_bench::N_ELEMENTS); });
+}
+
+BENCHMARK(ArrayFill, Double) {
+    state.items = array_bench::N_ELEMENTS;
+    state.run([] {
+        typeless::Array arr;
+        arr.set_type<double>();
+        arr.resize(array_bench::N_ELEMENTS);
+        bench::do_not_optimize(arr);
+    });
+}
+
+BENCHMARK(ArrayAccess, At) {
+    state.items = array_bench::N_ELEMENTS;
+    const typeless::Array& arr = array_bench::source<int>();
+    state.run([&] {
+        long long total = 0;
+        for (size_t i = 0; i < arr.size(); ++i) {
+            total += arr.at<int>(i);
+        }
+        bench::do_not_optimize(total);
+    });
+}
+
+BENCHMARK(ArrayAccess, Span) {
+    state.items = array_bench::N_ELEMENTS;
+    typeless::ArraySpan<const int> span(array_bench::source<int>());
+    state.run([&] {
+        long long total = 0;
+        for (int v : span) {
+            total += v;
+        }
+        bench::do_not_optimize(total);
+    });
+}
+
+BENCHMARK(ArrayBatches, Int) {
+    constexpr size_t N_BATCHES = 16;
+    state.items = array_bench::N_ELEMENTS;
+    const typeless::Array& arr = array_bench::source<int>();
+    size_t batch = array_bench::N_ELEMENTS / N_BATCHES;
+    state.run("copy", [&] {
+        const int* data = arr.data<int>();
+        for (size_t i = 0; i < N_BATCHES; ++i) {
+            typeless::Array copy(data + i * batch, data + (i + 1) * batch);
+            bench::do_not_optimize(copy);
+        }
+    });
+    state.run("slice", [&] {
+        for (size_t i = 0; i < N_BATCHES; ++i) {
+            typeless::ArrayView view = arr.slice(i * batch, batch);
+            bench::do_not_optimize(view);
+        }
+    });
+}
+
+BENCHMARK(ArrayCopy, IntCopyOnWrite) {
+    state.items = array_bench::N_ELEMENTS;
+    typeless::Array source = array_bench::source<int>();
+    source.set_copy_on_write(true);
+    state.run([&] {
+        typeless::Array copy(source);
+        bench::do_not_optimize(copy);
+    });
+}
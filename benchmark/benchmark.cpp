@@ -0,0 +1,11 @@
+#include "benchmark.h"
+#include "array_bench.h"
+#include "parallel_bench.h"
+#include "reduce_bench.h"
+#include "sort_bench.h"
+#include "stringize_bench.h"
+#include "variant_bench.h"
+
+int main(int argc, char** argv) {
+    return bench::run_all(argc > 1 ? argv[1] : nullptr);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+    /// \brief keep [value] alive so the optimizer cannot drop the code producing it
+    template <class T>
+    inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    class State {
+    public:
+        /// \brief run [fn] repeatedly for at least [min_time] seconds and record time per call
+        template <class Fn>
+        void run(Fn&& fn, double min_time = 0.25) {
+            using clock = std::chrono::steady_clock;
+            fn(); // warm up
+            size_t iterations = 1;
+            for (;;) {
+                auto start = clock::now();
+                for (size_t i = 0; i < iterations; ++i) {
+                    fn();
+                }
+                double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+                if (elapsed >= min_time) {
+                    ns_per_iter = elapsed * 1e9 / iterations;
+                    return;
+                }
+                iterations *= 2;
+            }
+        }
+
+        /// \brief like run() but reported as its own row, for benchmarks with several configurations
+        template <class Fn>
+        void run(const std::string& variant, Fn&& fn, double min_time = 0.25) {
+            run(std::forward<Fn>(fn), min_time);
+            variants.emplace_back(variant, ns_per_iter);
+        }
+
+        /// \brief number of items processed per call, used to print per-item time
+        size_t items = 1;
+        double ns_per_iter = 0;
+        std::vector<std::pair<std::string, double>> variants;
+    };
+
+    using BenchFn = void (*)(State&);
+
+    struct Entry {
+        const char* group;
+        const char* name;
+        BenchFn fn;
+    };
+
+    inline std::vector<Entry>& registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+
+    struct Registrar {
+        Registrar(const char* group, const char* name, BenchFn fn) {
+            registry().push_back({group, name, fn});
+        }
+    };
+
+    /// \brief run benchmarks whose "group.name" contains [filter], all if null
+    inline int run_all(const char* filter) {
+        std::printf("%-48s %16s %14s\n", "benchmark", "ns/iter", "ns/item");
+        for (const Entry& entry : registry()) {
+            std::string full = std::string(entry.group) + "." + entry.name;
+            if (filter != nullptr && full.find(filter) == std::string::npos) {
+                continue;
+            }
+            State state;
+            entry.fn(state);
+            double items = static_cast<double>(std::max<size_t>(state.items, 1));
+            if (state.variants.empty()) {
+                std::printf("%-48s %16.1f %14.3f\n", full.c_str(), state.ns_per_iter, state.ns_per_iter / items);
+            }
+            for (const auto& variant : state.variants) {
+                std::string name = full + "/" + variant.first;
+                std::printf("%-48s %16.1f %14.3f\n", name.c_str(), variant.second, variant.second / items);
+            }
+        }
+        return 0;
+    }
+} // namespace bench
+
+#define BENCHMARK(group, name)                                                   \
+    static void group##_##name(bench::State&);                                   \
+    static bench::Registrar group##_##name##_registrar(#group, #name, &group##_##name); \
+    static void group##_##name(bench::State& state)
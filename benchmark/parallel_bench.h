@@ -0,0 +1,76 @@
+#pragma once
+
+#include "benchmark.h"
+#include <thread>
+#include <typeless.h>
+#include <vector>
+
+namespace parallel_bench {
+    using typeless::Array;
+    using typeless::ThreadPool;
+
+    constexpr size_t N_ELEMENTS = 10000000;
+
+    inline const Array& numbers() {
+        static const Array arr = [] {
+            std::vector<int> v(N_ELEMENTS);
+            unsigned x = 2463534242u;
+            for (int& i : v) {
+                x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+                i = static_cast<int>(x % 1000000);
+            }
+            return Array(v.begin(), v.end());
+        }();
+        return arr;
+    }
+
+    /// \brief 1, 2, 4, 8 and all hardware threads
+    inline std::vector<size_t> thread_counts() {
+        std::vector<size_t> counts{1, 2, 4, 8};
+        size_t hardware = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+        if (hardware > 8) {
+            counts.push_back(hardware);
+        }
+        return counts;
+    }
+
+    template <class Fn>
+    void scale(bench::State& state, Fn&& fn) {
+        state.items = N_ELEMENTS;
+        for (size_t n_threads : thread_counts()) {
+            ThreadPool pool(n_threads);
+            state.run("threads:" + std::to_string(n_threads), [&] { fn(pool); });
+        }
+    }
+} // namespace parallel_bench
+
+BENCHMARK(Parallel, Reduce) {
+    const typeless::Array& arr = parallel_bench::numbers();
+    parallel_bench::scale(state, [&](typeless::ThreadPool& pool) {
+        bench::do_not_optimize(arr.reduce<int>(pool, 0LL, [](long long acc, long long v) { return acc + v; }));
+    });
+}
+
+BENCHMARK(Parallel, Filter) {
+    const typeless::Array& arr = parallel_bench::numbers();
+    parallel_bench::scale(state, [&](typeless::ThreadPool& pool) {
+        bench::do_not_optimize(arr.filter<int>(pool, [](int i) { return i % 3 == 0; }));
+    });
+}
+
+BENCHMARK(Parallel, Transform) {
+    typeless::Array arr = parallel_bench::numbers();
+    parallel_bench::scale(state, [&](typeless::ThreadPool& pool) {
+        arr.transform<int>(pool, [](int i) { return (i * 7 + 3) % 1000003; });
+        bench::do_not_optimize(arr);
+    });
+}
+
+BENCHMARK(Parallel, Sort) {
+    const typeless::Array& arr = parallel_bench::numbers();
+    parallel_bench::scale(state, [&](typeless::ThreadPool& pool) {
+        typeless::Array copy = arr;
+        copy.sort<int>(pool);
+        bench::do_not_optimize(copy);
+    });
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "benchmark.h"
+#include <numeric>
+#include <typeless.h>
+#include <vector>
+
+namespace reduce_bench {
+    using typeless::Array;
+
+    constexpr size_t N_ELEMENTS = 10000000;
+
+    template <class T>
+    Array& numbers() {
+        static Array arr = [] {
+            std::vector<T> v(N_ELEMENTS);
+            for (size_t i = 0; i < N_ELEMENTS; ++i) {
+                v[i] = static_cast<T>(i % 1000);
+            }
+            return Array(v.begin(), v.end());
+        }();
+        return arr;
+    }
+
+    template <class T>
+    void add(const T& v, long long& sum) {
+        sum += v;
+    }
+} // namespace reduce_bench
+
+BENCHMARK(SumInt, Join) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.join<int, long long>(reduce_bench::add<int>)); });
+}
+
+BENCHMARK(SumInt, Sum) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.sum<int>()); });
+}
+
+BENCHMARK(SumInt, SumScalar) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    auto previous = typeless::internal::simd::set_level(typeless::internal::simd::Level::scalar);
+    state.run([&] { bench::do_not_optimize(arr.sum<int>()); });
+    typeless::internal::simd::set_level(previous);
+}
+
+BENCHMARK(SumDouble, Accumulate) {
+    typeless::Array& arr = reduce_bench::numbers<double>();
+    state.items = reduce_bench::N_ELEMENTS;
+    const double* p = arr.data<double>();
+    state.run([&] { bench::do_not_optimize(std::accumulate(p, p + reduce_bench::N_ELEMENTS, 0.0)); });
+}
+
+BENCHMARK(SumDouble, Sum) {
+    typeless::Array& arr = reduce_bench::numbers<double>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.sum<double>()); });
+}
+
+BENCHMARK(MinMaxInt, Scalar) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    auto previous = typeless::internal::simd::set_level(typeless::internal::simd::Level::scalar);
+    state.run([&] { bench::do_not_optimize(arr.minmax<int>()); });
+    typeless::internal::simd::set_level(previous);
+}
+
+BENCHMARK(MinMaxInt, MinMax) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.minmax<int>()); });
+}
+
+BENCHMARK(DotFloat, InnerProduct) {
+    typeless::Array& arr = reduce_bench::numbers<float>();
+    state.items = reduce_bench::N_ELEMENTS;
+    const float* p = arr.data<float>();
+    state.run([&] { bench::do_not_optimize(std::inner_product(p, p + reduce_bench::N_ELEMENTS, p, 0.0f)); });
+}
+
+BENCHMARK(DotFloat, Dot) {
+    typeless::Array& arr = reduce_bench::numbers<float>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.dot<float>(arr)); });
+}
+
+BENCHMARK(DotInt, Scalar) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    auto previous = typeless::internal::simd::set_level(typeless::internal::simd::Level::scalar);
+    state.run([&] { bench::do_not_optimize(arr.dot<int>(arr)); });
+    typeless::internal::simd::set_level(previous);
+}
+
+BENCHMARK(DotInt, Dot) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.dot<int>(arr)); });
+}
+
+BENCHMARK(DotInt64, Scalar) {
+    typeless::Array& arr = reduce_bench::numbers<long long>();
+    state.items = reduce_bench::N_ELEMENTS;
+    auto previous = typeless::internal::simd::set_level(typeless::internal::simd::Level::scalar);
+    state.run([&] { bench::do_not_optimize(arr.dot<long long>(arr)); });
+    typeless::internal::simd::set_level(previous);
+}
+
+BENCHMARK(DotInt64, Dot) {
+    typeless::Array& arr = reduce_bench::numbers<long long>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.dot<long long>(arr)); });
+}
+
+namespace reduce_bench {
+    constexpr size_t N_STRINGS = 10000;
+
+    inline Array& strings() {
+        static Array arr = [] {
+            std::vector<std::string> v(N_STRINGS);
+            for (size_t i = 0; i < N_STRINGS; ++i) {
+                v[i] = std::to_string(i % 1000);
+            }
+            return Array(v.begin(), v.end());
+        }();
+        return arr;
+    }
+
+    template <class T, class TResult>
+    void join_add(const T& v, TResult& result) {
+        result += v;
+    }
+} // namespace reduce_bench
+
+BENCHMARK(FoldInt, JoinFunctionPointer) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.join<int>(reduce_bench::join_add<int, int>)); });
+}
+
+BENCHMARK(FoldInt, Reduce) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.reduce<int>(0, [](int acc, int v) { return acc + v; })); });
+}
+
+BENCHMARK(FoldInt, Accumulate) {
+    typeless::Array& arr = reduce_bench::numbers<int>();
+    state.items = reduce_bench::N_ELEMENTS;
+    const int* p = arr.data<int>();
+    state.run([&] { bench::do_not_optimize(std::accumulate(p, p + reduce_bench::N_ELEMENTS, 0)); });
+}
+
+BENCHMARK(FoldDouble, JoinFunctionPointer) {
+    typeless::Array& arr = reduce_bench::numbers<double>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.join<double>(reduce_bench::join_add<double, double>)); });
+}
+
+BENCHMARK(FoldDouble, Reduce) {
+    typeless::Array& arr = reduce_bench::numbers<double>();
+    state.items = reduce_bench::N_ELEMENTS;
+    state.run([&] { bench::do_not_optimize(arr.reduce<double>(0.0, [](double acc, double v) { return acc + v; })); });
+}
+
+BENCHMARK(FoldDouble, Accumulate) {
+    typeless::Array& arr = reduce_bench::numbers<double>();
+    state.items = reduce_bench::N_ELEMENTS;
+    const double* p = arr.data<double>();
+    state.run([&] { bench::do_not_optimize(std::accumulate(p, p + reduce_bench::N_ELEMENTS, 0.0)); });
+}
+
+BENCHMARK(FoldString, JoinFunctionPointer) {
+    typeless::Array& arr = reduce_bench::strings();
+    state.items = reduce_bench::N_STRINGS;
+    state.run([&] { bench::do_not_optimize(arr.join<std::string>(reduce_bench::join_add<std::string, std::string>)); });
+}
+
+BENCHMARK(FoldString, Reduce) {
+    typeless::Array& arr = reduce_bench::strings();
+    state.items = reduce_bench::N_STRINGS;
+    state.run([&] {
+        bench::do_not_optimize(arr.reduce<std::string>(std::string(), [](std::string acc, const std::string& s) {
+            acc += s;
+            return acc;
+        }));
+    });
+}
+
+BENCHMARK(FoldString, Accumulate) {
+    typeless::Array& arr = reduce_bench::strings();
+    state.items = reduce_bench::N_STRINGS;
+    const std::string* p = arr.data<std::string>();
+    // std::accumulate copies the accumulator on every step before C++20
+    state.run([&] { bench::do_not_optimize(std::accumulate(p, p + reduce_bench::N_STRINGS, std::string())); });
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "benchmark.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <typeless.h>
+#include <vector>
+
+namespace sort_bench {
+    using typeless::Array;
+
+    constexpr size_t N_ELEMENTS = 1 << 22;
+
+    template <class T>
+    const Array& unsorted() {
+        static const Array arr = [] {
+            std::mt19937_64 rng(42);
+            std::vector<T> v(N_ELEMENTS);
+            for (T& x : v)
+                x = static_cast<T>(static_cast<std::int64_t>(rng()) >> 16);
+            return Array(v.begin(), v.end());
+        }();
+        return arr;
+    }
+
+    /// \brief both variants copy the unsorted array first, so the copy is part of every row
+    template <class T>
+    void run(bench::State& state) {
+        state.items = N_ELEMENTS;
+        state.run("std::sort", [] {
+            Array arr(unsorted<T>());
+            arr.sort<T>(std::less<T>());
+            bench::do_not_optimize(arr);
+        });
+        state.run("radix", [] {
+            Array arr(unsorted<T>());
+            arr.sort<T>();
+            bench::do_not_optimize(arr);
+        });
+    }
+} // namespace sort_bench
+
+BENCHMARK(Sort, Int32) {
+    sort_bench::run<std::int32_t>(state);
+}
+
+BENCHMARK(Sort, Int64) {
+    sort_bench::run<std::int64_t>(state);
+}
+
+BENCHMARK(Sort, Double) {
+    sort_bench::run<double>(state);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "benchmark.h"
+#include <sstream>
+#include <typeless.h>
+
+namespace stringize_bench {
+    using typeless::Array;
+    using typeless::Object;
+
+    constexpr size_t N_OBJECTS = 4096;
+
+    /// \brief Array of Objects holding ints, doubles, strings and C strings
+    inline const Array& mixed_objects() {
+        static const Array arr = [] {
+            Array arr;
+            arr.set_type<Object>();
+            arr.resize(N_OBJECTS);
+            for (size_t i = 0; i < N_OBJECTS; ++i) {
+                switch (i % 4) {
+                case 0: arr.set(i, Object(static_cast<int>(i * 7919))); break;
+                case 1: arr.set(i, Object(static_cast<double>(i) / 3.0)); break;
+                case 2: arr.set(i, Object(std::string("item-") + std::to_string(i))); break;
+                default: arr.set(i, Object("literal")); break;
+                }
+            }
+            return arr;
+        }();
+        return arr;
+    }
+
+    /// \brief the previous to_string path: std::to_string and a fresh string per value
+    inline std::string legacy_to_string(const Object& obj) {
+        if (obj.has_type<int>()) {
+            return std::to_string(obj.get<int>());
+        }
+        if (obj.has_type<double>()) {
+            return std::to_string(obj.get<double>());
+        }
+        if (obj.has_type<std::string>()) {
+            return obj.get<std::string>();
+        }
+        if (obj.has_type<const char*>()) {
+            return obj.get<const char*>();
+        }
+        return "null";
+    }
+} // namespace stringize_bench
+
+BENCHMARK(Stringize, LegacyToString) {
+    using namespace stringize_bench;
+    const Array& arr = mixed_objects();
+    state.items = N_OBJECTS;
+    state.run([&] {
+        std::string line;
+        arr.for_each<Object>([&](const Object& obj) {
+            line += legacy_to_string(obj);
+            line += ' ';
+        });
+        bench::do_not_optimize(line);
+    });
+}
+
+BENCHMARK(Stringize, ToString) {
+    using namespace stringize_bench;
+    const Array& arr = mixed_objects();
+    state.items = N_OBJECTS;
+    state.run([&] {
+        std::string line;
+        arr.for_each<Object>([&](const Object& obj) {
+            line += obj.to_string();
+            line += ' ';
+        });
+        bench::do_not_optimize(line);
+    });
+}
+
+BENCHMARK(Stringize, AppendTo) {
+    using namespace stringize_bench;
+    const Array& arr = mixed_objects();
+    state.items = N_OBJECTS;
+    std::string line;
+    state.run([&] {
+        line.clear(); // buffer is reused across iterations, so no allocation once warmed up
+        arr.for_each<Object>([&](const Object& obj) {
+            obj.append_to(line);
+            line += ' ';
+        });
+        bench::do_not_optimize(line);
+    });
+}
+
+BENCHMARK(Stringize, OstreamLegacy) {
+    using namespace stringize_bench;
+    const Array& arr = mixed_objects();
+    state.items = N_OBJECTS;
+    state.run([&] {
+        std::ostringstream os;
+        arr.for_each<Object>([&](const Object& obj) { os << legacy_to_string(obj) << ' '; });
+        bench::do_not_optimize(os);
+    });
+}
+
+BENCHMARK(Stringize, Ostream) {
+    using namespace stringize_bench;
+    const Array& arr = mixed_objects();
+    state.items = N_OBJECTS;
+    state.run([&] {
+        std::ostringstream os;
+        arr.for_each<Object>([&](const Object& obj) { os << obj << ' '; });
+        bench::do_not_optimize(os);
+    });
+}
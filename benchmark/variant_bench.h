@@ -0,0 +1,62 @@
+#pragma once
+
+#include "benchmark.h"
+#include <string>
+#include <typeless.h>
+
+namespace variant_bench {
+    using typeless::Array;
+    using typeless::Object;
+    using typeless::VariantArray;
+
+    constexpr size_t N_RECORDS = 1 << 18; // each record is an int, a double and a string
+
+    const Array& objects() {
+        static const Array arr = [] {
+            Array objects;
+            objects.set_type<Object>();
+            objects.reserve(N_RECORDS * 3);
+            for (size_t i = 0; i < N_RECORDS; ++i) {
+                objects.emplace_back<Object>(static_cast<int>(i));
+                objects.emplace_back<Object>(i * 0.5);
+                objects.emplace_back<Object>(std::string("record"));
+            }
+            return objects;
+        }();
+        return arr;
+    }
+
+    const VariantArray& packed() {
+        static const VariantArray arr(objects());
+        return arr;
+    }
+} // namespace variant_bench
+
+BENCHMARK(VariantScan, SumInts) {
+    state.items = variant_bench::N_RECORDS * 3;
+    state.run("Array<Object>", [] {
+        long long total = 0;
+        variant_bench::objects().for_each<typeless::Object>([&](const typeless::Object& obj) {
+            if (obj.has_type<int>())
+                total += obj.get<int>();
+        });
+        bench::do_not_optimize(total);
+    });
+    state.run("VariantArray", [] {
+        long long total = 0;
+        variant_bench::packed().for_each<int>([&](int v) { total += v; });
+        bench::do_not_optimize(total);
+    });
+}
+
+BENCHMARK(VariantScan, Copy) {
+    state.items = variant_bench::N_RECORDS * 3;
+    state.run("Array<Object>", [] {
+        typeless::Array copy(variant_bench::objects());
+        bench::do_not_optimize(copy);
+    });
+    state.run("VariantArray", [] {
+        typeless::VariantArray copy(variant_bench::packed());
+        bench::do_not_optimize(copy);
+    });
+}
@@ -11,21 +11,68 @@
 #define __TYPELESS_ALLOCATOR std::allocator
 #endif
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#define __TYPELESS_FUNCSIG __FUNCSIG__
+#else
+#define __TYPELESS_FUNCSIG __PRETTY_FUNCTION__
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if !defined(__TYPELESS_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define __TYPELESS_SIMD
+#include <immintrin.h>
+#endif
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
 
 namespace typeless {
     struct ObjectBase;
     struct ArrayBase;
+    struct SharedObjectBase;
+    struct ThreadPoolBase;
     class Object;
     class Array;
+    class SharedObject;
+    class ThreadPool;
+    template <class T>
+    class TypedArray;
+    template <class T>
+    class ArraySpan;
+    class VariantRef;
+    class VariantArray;
+    class TableRow;
+    class Table;
+    class ArrayView;
 
     using std::string;
     using std::type_info;
@@ -33,48 +80,160 @@ namespace typeless {
     using ArrayInit = std::initializer_list<T>;
     using ObjectArray = ArrayInit<Object>;
     using StringArray = ArrayInit<string>;
+#if __cplusplus >= 201703L
+    using std::in_place_type;
+    using std::in_place_type_t;
+#else
+    template <class T>
+    struct in_place_type_t {
+        explicit in_place_type_t() = default;
+    };
+    template <class T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
 
     namespace stringizer {
-        using std::to_string;
-        inline std::string to_string(const std::string& s);
-        inline std::string to_string(const char* c_str);
-        inline std::string to_string(const char& ch);
-        inline std::string to_string(const Object& obj);
+        inline void append_to(std::string& out, const std::string& s);
+        inline void append_to(std::string& out, const char* c_str);
+        inline void append_to(std::string& out, const char& ch);
+        inline void append_to(std::string& out, const bool& b);
+        inline void append_to(std::string& out, const Object& obj);
+        template <class T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+        void append_to(std::string& out, const T& value);
+        template <class T, std::enable_if_t<!std::is_arithmetic<T>::value, int> = 0>
+        void append_to(std::string& out, const T&);
         template <class T>
-        std::string to_string(const T&);
+        std::string to_string(const T& value);
     } // namespace stringizer
 
     namespace internal {
-        class ObjectHelper {
-        public:
-            virtual void* get_allocator() = 0;
-            virtual void* allocate() = 0;
-            virtual void destroy_deallocate(void* ptr) = 0;
-            virtual void* make_copy(const void* src) = 0;
-            virtual bool equal(const void* lhs, const void* rhs) = 0;
-            virtual string to_string(const void* ptr) = 0;
-            virtual const type_info* type() = 0;
-            virtual bool less(const void*, const void*) = 0;
-            virtual Object sum(const void* a, const void* b) = 0;
-            virtual Object difference(const void* a, const void* b) = 0;
-            virtual Object product(const void* a, const void* b) = 0;
-            virtual Object quotient(const void* a, const void* b) = 0;
-        };
-
-        class ArrayHelper {
-        public:
-            virtual void* get_allocator() = 0;
-            virtual void* allocate(size_t size) = 0;                             // allocate new array with n size
-            virtual void destroy_deallocate(void* ptr, size_t n) = 0;            // destroy and deallocate whole array
-            virtual void construct(void* ptr, size_t n) = 0;                     // call constructor of elements from [ptr] to [ptr+n]
-            virtual void construct(void* ptr, const void* value) = 0;            // construct single element
-            virtual void destruct(void* ptr) = 0;                                // destruct single element
-            virtual void* make_copy(const void* src, size_t n) = 0;              // make a copy of array [src]
-            virtual void* make_copy(const void* src, size_t size, size_t n) = 0; // make a copy of array [src] but only n is copied
-            virtual ptrdiff_t distance(const void* high, const void* low) = 0;   // like std::distance
-            virtual void* advance(void* ptr, size_t n) = 0;                      // like std::advance
-            virtual const void* advance(const void* ptr, size_t n) = 0;          // like std::advance
-            virtual const type_info* type() = 0;
+        using TypeId = std::uint64_t;
+
+        /// \brief FNV-1a hash of a null-terminated string
+        constexpr std::uint64_t fnv1a(const char* s, std::uint64_t h = 14695981039346656037ull) {
+            while (*s != '\0') {
+                h = (h ^ static_cast<unsigned char>(*s++)) * 1099511628211ull;
+            }
+            return h;
+        }
+
+        /// \brief true if [sub] occurs in the null-terminated string [s]
+        constexpr bool contains(const char* s, const char* sub) {
+            for (; *s != '\0'; ++s) {
+                size_t i = 0;
+                while (sub[i] != '\0' && s[i] == sub[i]) {
+                    ++i;
+                }
+                if (sub[i] == '\0') {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <class T>
+        constexpr TypeId type_id_of() noexcept {
+            return fnv1a(__TYPELESS_FUNCSIG);
+        }
+
+        template <class T>
+        constexpr bool unique_name_of() noexcept {
+            // anonymous namespaces, lambdas and local classes
+            return !contains(__TYPELESS_FUNCSIG, "anonymous") && !contains(__TYPELESS_FUNCSIG, "lambda") &&
+                   !contains(__TYPELESS_FUNCSIG, ")::") && !contains(__TYPELESS_FUNCSIG, "`");
+        }
+
+        /// \brief compile time identity of T, computed from its spelled name.
+        ///        Equal in every module built with the same compiler,
+        ///        so it can be compared across shared libraries.
+        template <class T>
+        constexpr TypeId type_id() noexcept {
+            return std::integral_constant<TypeId, type_id_of<std::remove_cv_t<std::remove_reference_t<T>>>()>::value;
+        }
+
+        /// \brief false if the spelled name of T may also name a type of another translation unit,
+        ///        only then can type_id<T>() equal the id of a different type
+        template <class T>
+        constexpr bool unique_type_id() noexcept {
+            return std::integral_constant<bool, unique_name_of<std::remove_cv_t<std::remove_reference_t<T>>>()>::value;
+        }
+
+        /// \brief per-type operation table, one constant instance per type
+        struct ObjectHelper {
+            void* (*get_allocator)();
+            void* (*allocate)();
+            void (*destroy_deallocate)(void* ptr);                // destroy value and deallocate if stored on heap
+            void* (*make_copy)(void* storage, const void* src);   // copy into [storage] if it fits, on heap otherwise
+            void* (*make_move)(void* storage, void* src);         // like make_copy but move constructs from [src]
+            void* (*relocate)(void* storage, void* src);          // move inline value [src] into [storage] and destroy [src]
+            void (*copy_assign)(void* dst, const void* src);      // copy assign over existing value, null if not copy assignable
+            void (*copy_construct)(void* dst, const void* src);   // copy construct into [dst] which has room for size bytes
+            void (*destruct)(void* ptr);                          // destroy value in place without deallocating
+            size_t size;
+            size_t align;
+            bool trivially_copyable;
+            bool (*equal)(const void* lhs, const void* rhs);
+            size_t (*hash)(const void* ptr);
+            void (*append_to)(string& out, const void* ptr);     // append string form of value to [out]
+            const type_info* type;
+            TypeId type_id;
+            bool unique_type_id;       // type_id alone identifies the type
+            unsigned char arith_index; // 1-based index in ArithmeticTypes, 0 if not promotable
+            bool (*less)(const void*, const void*);
+            Object (*sum)(const void* a, const void* b);
+            Object (*difference)(const void* a, const void* b);
+            Object (*product)(const void* a, const void* b);
+            Object (*quotient)(const void* a, const void* b);
+            void (*sum_assign)(void* a, const void* b);        // a += b
+            void (*difference_assign)(void* a, const void* b); // a -= b
+            void (*product_assign)(void* a, const void* b);    // a *= b
+            void (*quotient_assign)(void* a, const void* b);   // a /= b
+        };
+
+        /// \brief operations on a pair of different arithmetic types
+        struct PromotedOps {
+            bool (*less)(const void*, const void*);
+            bool (*equal)(const void*, const void*);
+            Object (*sum)(const void* a, const void* b);
+            Object (*difference)(const void* a, const void* b);
+            Object (*product)(const void* a, const void* b);
+            Object (*quotient)(const void* a, const void* b);
+            void (*sum_assign)(void* a, const void* b);
+            void (*difference_assign)(void* a, const void* b);
+            void (*product_assign)(void* a, const void* b);
+            void (*quotient_assign)(void* a, const void* b);
+        };
+
+        /// \brief per-type operation table, one constant instance per type
+        struct ArrayHelper {
+            void* (*get_allocator)();
+            void* (*allocate)(size_t size);                                 // allocate new array with n size
+            void (*destroy_deallocate)(void* ptr, size_t n, size_t capacity); // destroy n elements and deallocate capacity
+            void (*construct_default)(void* ptr, size_t n);                 // call constructor of elements from [ptr] to [ptr+n]
+            void (*construct)(void* ptr, const void* value);                // construct single element
+            void (*destruct)(void* ptr);                                    // destruct single element
+            void (*destroy)(void* ptr, size_t n);                           // destruct elements from [ptr] to [ptr+n]
+            void* (*make_copy)(const void* src, size_t n);                  // make a copy of array [src]
+            void* (*make_partial_copy)(const void* src, size_t size, size_t n); // make a copy of array [src] but only n is copied
+            void* (*reallocate)(void* ptr, size_t n, size_t capacity, size_t new_capacity); // transfer n elements into new storage
+            ptrdiff_t (*distance)(const void* high, const void* low);       // like std::distance
+            void* (*advance)(const void* ptr, size_t n);                    // like std::advance
+            bool (*equal)(const void* lhs, const void* rhs, size_t n);      // compare n elements
+            size_t (*hash)(const void* ptr, size_t n);                      // hash n elements
+            const type_info* type;
+            TypeId type_id;
+            bool unique_type_id;                                            // type_id alone identifies the type
+        };
+
+        constexpr size_t OBJECT_INLINE_SIZE = 16;
+        using InlineStorage = std::aligned_storage_t<OBJECT_INLINE_SIZE, alignof(std::max_align_t)>;
+
+        /// \brief true if T is stored inside Object instead of on heap
+        template <class T>
+        struct IsInlineObject
+            : std::integral_constant<bool, sizeof(T) <= sizeof(InlineStorage) &&
+                                               alignof(InlineStorage) % alignof(T) == 0 &&
+                                               std::is_nothrow_move_constructible<T>::value> {
         };
 
         template <class TValue, class TResult>
@@ -85,27 +244,170 @@ namespace typeless {
         template <class T>
         void copy_construct_at(T* p, const T& value);
         template <class T>
+        void move_construct_at(T* p, T& value);
+        template <class T>
         void destroy_at(T* p);
         template <class T>
         void destroy_n(T* p, size_t n);
+        template <class T, class Value>
+        void assign_value(void* dst, Value&& value, std::true_type);
+        template <class T, class Value>
+        void assign_value(void* dst, Value&& value, std::false_type);
         template <class Iterator>
         void move(Iterator src, Iterator dst);
+        template <class T, class Pred>
+        T* compact_if(T* first, T* last, T* out, Pred& keep);
+        template <class T, class Pred>
+        size_t mark_if(const T* first, size_t n, bool* marks, Pred& keep);
+        template <class T>
+        T* copy_marked(const T* first, size_t n, const bool* marks, T* out);
+
+        template <class T, class Allocator_ = __TYPELESS_ALLOCATOR<T>>
+        struct ObjectHelperTable;
+
+        struct SharedBlock;
+        struct ArrayBlock;
+
+        using LessFn = bool (*)(const void*, const void*);
+        LessFn less_function(const ObjectHelper* l, const ObjectHelper* r) noexcept;
+        LessFn equal_function(const ObjectHelper* l, const ObjectHelper* r) noexcept;
+        size_t hash_bytes(const void* data, size_t len) noexcept;
+        template <class T>
+        char* format_number(char* first, char* last, T value) noexcept;
+
+        constexpr size_t CACHE_LINE_SIZE = 64;
+
+        constexpr size_t VARIANT_INLINE_SIZE = 8;
+        constexpr size_t VARIANT_CHUNK_SIZE = 4096;
+        using VariantSlot = std::aligned_storage_t<VARIANT_INLINE_SIZE, VARIANT_INLINE_SIZE>;
+
+        /// \brief true if VariantArray stores T in the slot itself instead of the arena
+        template <class T>
+        struct IsVariantInline
+            : std::integral_constant<bool, std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(VariantSlot) &&
+                                               alignof(VariantSlot) % alignof(T) == 0> {
+        };
+
+        inline bool is_variant_inline(const ObjectHelper* helper) noexcept {
+            return helper->trivially_copyable && helper->size <= sizeof(VariantSlot) &&
+                   alignof(VariantSlot) % helper->align == 0;
+        }
+
+        /// \brief one unit of work of a ThreadPool, [run] is called with [job] and [index]
+        struct PoolTask {
+            void (*run)(void* job, size_t index);
+            void* job;
+            size_t index;
+        };
+
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<PoolTask> tasks; // owner takes from back, thieves from front
+        };
+
+        /// \brief split of [n] elements into chunks of about [chunk_bytes],
+        ///        chunk boundaries after the first fall on cache line boundaries
+        class ChunkLayout {
+        public:
+            ChunkLayout(const void* data, size_t n, size_t element_size, size_t chunk_bytes) noexcept;
+            size_t count() const noexcept { return count_; }
+            size_t begin(size_t chunk) const noexcept { return chunk == 0 ? 0 : std::min(n_, head_ + chunk * step_); }
+            size_t end(size_t chunk) const noexcept { return std::min(n_, head_ + (chunk + 1) * step_); }
+
+        private:
+            size_t n_, head_, step_, count_;
+        };
+
+        /// \brief element type of Array::map, [U] if given, otherwise the result type of [F]
+        template <class U, class F, class T>
+        using MapResult = std::conditional_t<std::is_void<U>::value,
+                                             std::decay_t<decltype(std::declval<F&>()(std::declval<const T&>()))>, U>;
+
+        /// \brief construct dst[i] from f(src[i]), constructed elements are destroyed if [f] throws
+        template <class T, class U, class F>
+        void map_n(const T* src, size_t n, U* dst, F& f) {
+            size_t i = 0;
+            try {
+                for (; i < n; ++i) {
+                    ::new (dst + i) U(f(src[i]));
+                }
+            } catch (...) {
+                destroy_n(dst, i);
+                throw;
+            }
+        }
+
+        /// \brief true if T is sorted by radix sort: integers up to 64 bits, float and double
+        template <class T>
+        struct IsRadixSortable
+            : std::integral_constant<bool, (std::is_integral<T>::value && sizeof(T) <= 8) ||
+                                               std::is_same<T, float>::value || std::is_same<T, double>::value> {
+        };
+
+        template <class T>
+        void radix_sort(T* data, size_t n);
+        template <class T>
+        void stable_sort(T* data, size_t n);
+
+        /// \brief result of sum and dot, 64-bit for integers and T for floating point
+        template <class T>
+        using SumType = std::conditional_t<std::is_floating_point<T>::value, T,
+                                           std::conditional_t<std::is_signed<T>::value, long long, unsigned long long>>;
+
+        /// \brief reduction kernels for arithmetic arrays, vectorized where the CPU allows
+        namespace simd {
+            enum class Level : int { scalar, sse2, avx2, avx512 };
+            Level detected_level() noexcept;
+            Level level() noexcept;
+            Level set_level(Level new_level) noexcept;
+            template <class T>
+            SumType<T> sum(const T* p, size_t n) noexcept;
+            template <class T>
+            std::pair<T, T> minmax(const T* p, size_t n) noexcept;
+            template <class T>
+            SumType<T> dot(const T* a, const T* b, size_t n) noexcept;
+        } // namespace simd
+        size_t hash_combine(size_t seed, size_t h) noexcept;
+        const PromotedOps* promoted_ops(const ObjectHelper* l, const ObjectHelper* r) noexcept;
+        template <class L, class R>
+        bool same_type(const L* l, const R* r) noexcept;
+        template <class T, class Helper>
+        bool has_type(const Helper* helper) noexcept;
 
         template <class T, class Allocator_ = __TYPELESS_ALLOCATOR<T>>
-        ObjectHelper* GetObjectHelper();
+        const ObjectHelper* GetObjectHelper() noexcept;
         template <class T, class Allocator_ = __TYPELESS_ALLOCATOR<T>>
-        ArrayHelper* GetArrayHelper();
+        const ArrayHelper* GetArrayHelper() noexcept;
     }; // namespace internal
 
     struct ObjectBase {
-        mutable internal::ObjectHelper* helper_;
-        mutable void* value_;
+        mutable const internal::ObjectHelper* helper_;
+        mutable void* value_;            // points to storage_ for inline values
+        mutable internal::InlineStorage storage_;
     };
 
     struct ArrayBase {
-        mutable internal::ArrayHelper* helper_;
+        mutable const internal::ArrayHelper* helper_;
+        mutable size_t elem_size_; // sizeof element, 1 without a type so size() needs no check
         mutable void* arr_;
         mutable void* end_;
+        mutable void* cap_; // end of allocated storage
+        mutable internal::ArrayBlock* block_; // shared with ArrayViews and copies, null while storage is owned alone
+        bool cow_;                            // copies share the buffer until one of them is changed
+    };
+
+    struct SharedObjectBase {
+        mutable internal::SharedBlock* block_;
+    };
+
+    struct ThreadPoolBase {
+        std::vector<std::unique_ptr<internal::WorkQueue>> queues_; // queue 0 is shared by outside callers
+        std::vector<std::thread> workers_;
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        std::atomic<size_t> pending_; // tasks queued and not yet taken
+        bool stop_;
+        size_t chunk_size_;
     };
 
     class Object : __TYPELESS_ACCESS_LEVEL ObjectBase {
@@ -113,8 +415,10 @@ namespace typeless {
         /* constructor */
         Object();
         ~Object() noexcept;
-        template <class T>
-        Object(const T& obj);
+        template <class T, class = std::enable_if_t<!std::is_same<std::decay_t<T>, Object>::value>>
+        Object(T&& obj);
+        template <class T, class... Args>
+        explicit Object(in_place_type_t<T>, Args&&... args);
         Object(const Object& rhs);
         Object(Object&&) noexcept;
         Object& operator=(const Object& rhs);
@@ -133,6 +437,10 @@ namespace typeless {
         friend Object operator-(const Object& l, const Object& r);
         friend Object operator*(const Object& l, const Object& r);
         friend Object operator/(const Object& l, const Object& r);
+        Object& operator+=(const Object& rhs);
+        Object& operator-=(const Object& rhs);
+        Object& operator*=(const Object& rhs);
+        Object& operator/=(const Object& rhs);
         /* getter */
         void* data() const noexcept;
         template <class T>
@@ -141,7 +449,10 @@ namespace typeless {
         T get() const;
         /* setter */
         template <class T>
-        void set(const T& val);
+        bool set(T&& val);
+        bool assign(const Object& rhs);
+        template <class T, class... Args>
+        T& emplace(Args&&... args);
         /* utilities */
         Object clone() const;
         bool empty() const noexcept;
@@ -149,11 +460,20 @@ namespace typeless {
         void invalidate() const noexcept;
         void swap(Object& right) noexcept;
         std::string to_string() const;
+        void append_to(std::string& out) const;
+        bool is_inline() const noexcept;
+        size_t hash() const;
         /* type */
         template <typename T>
         bool has_type() const noexcept;
+        internal::TypeId type_id() const noexcept;
         const type_info& type() const noexcept;
         const char* type_name() const noexcept;
+
+    private:
+        friend class VariantRef;
+        friend class VariantArray;
+        friend class Table;
     };
 
     class Array : __TYPELESS_ACCESS_LEVEL ArrayBase {
@@ -169,11 +489,14 @@ namespace typeless {
         Array& operator=(const Array& rhs);
         Array& operator=(Array&& rhs) noexcept;
         ~Array() noexcept;
+        /* comparison */
+        friend bool operator==(const Array& l, const Array& r);
+        friend bool operator!=(const Array& l, const Array& r);
         /* getter */
         template <class T>
         const T* data() const noexcept;
         template <class T>
-        T* data() noexcept;
+        T* data();
         template <class T>
         T& at(size_t idx);
         template <class T>
@@ -183,65 +506,546 @@ namespace typeless {
         void set_type();
         template <class T>
         void set(size_t off, const T& ele);
+        template <class T>
+        void push_back(T&& ele);
+        template <class T, class... Args>
+        T& emplace_back(Args&&... args);
         /* utilities */
         template <class T, class Callback>
         void for_each(Callback cb) const;
         template <class T, class Fn>
         Array filter(Fn filter_fn) const;
+        template <class T, class Pred>
+        size_t erase_if(Pred pred);
+        template <class T, class Pred>
+        size_t retain(Pred pred);
         template <class T, class TResult = T>
-        TResult join(void (*cb)(const T&, TResult&) = internal::default_join<T, TResult>);
+        TResult join(void (*cb)(const T&, TResult&) = internal::default_join<T, TResult>) const;
+        template <class T, class TResult = T, class F>
+        TResult join(F&& cb) const;
+        template <class T, class TResult, class BinaryOp>
+        TResult reduce(TResult init, BinaryOp&& op) const;
+        template <class T, class F>
+        void transform(F f);
+        template <class T, class U = void, class F>
+        Array map(F&& f) const;
+        ArrayView slice(size_t offset, size_t length) const;
+        /* sorting and searching */
+        template <class T>
+        void sort();
+        template <class T, class Compare>
+        void sort(Compare comp);
+        template <class T>
+        void stable_sort();
+        template <class T, class Compare>
+        void stable_sort(Compare comp);
+        template <class T, class Compare = std::less<T>>
+        void partial_sort(size_t middle, Compare comp = Compare());
+        template <class T, class Compare = std::less<T>>
+        void nth_element(size_t nth, Compare comp = Compare());
+        template <class T, class Compare = std::less<T>>
+        size_t lower_bound(const T& value, Compare comp = Compare()) const;
+        template <class T, class Compare = std::less<T>>
+        size_t upper_bound(const T& value, Compare comp = Compare()) const;
+        template <class T, class Compare = std::less<T>>
+        bool binary_search(const T& value, Compare comp = Compare()) const;
+        /* parallel */
+        template <class T, class Callback>
+        void for_each(ThreadPool& pool, Callback cb) const;
+        template <class T, class Fn>
+        Array filter(ThreadPool& pool, Fn filter_fn) const;
+        template <class T, class TResult, class BinaryOp>
+        TResult reduce(ThreadPool& pool, TResult init, BinaryOp op) const;
+        template <class T, class TResult, class BinaryOp, class Combine>
+        TResult reduce(ThreadPool& pool, TResult init, BinaryOp op, Combine combine) const;
+        template <class T, class F>
+        void transform(ThreadPool& pool, F f);
+        template <class T, class U = void, class F>
+        Array map(ThreadPool& pool, F f) const;
+        template <class T, class Compare = std::less<T>>
+        void sort(ThreadPool& pool, Compare comp = Compare());
+        /* numeric */
+        template <class T>
+        internal::SumType<T> sum() const noexcept;
+        template <class T>
+        T min() const noexcept;
+        template <class T>
+        T max() const noexcept;
+        template <class T>
+        std::pair<T, T> minmax() const noexcept;
+        template <class T>
+        double mean() const noexcept;
+        template <class T>
+        internal::SumType<T> dot(const Array& other) const noexcept;
         bool empty() const noexcept;
         size_t size() const noexcept;
         void resize(size_t new_size);
+        size_t capacity() const noexcept;
+        void reserve(size_t new_capacity);
+        void shrink_to_fit();
         void destroy() noexcept;
         void invalidate() noexcept;
         void swap(Array& right) noexcept;
+        size_t hash() const;
+        /* copy on write */
+        void set_copy_on_write(bool enable);
+        bool copy_on_write() const noexcept;
+        size_t use_count() const noexcept;
+        /* type */
+        template <typename T>
+        bool has_type() const noexcept;
+        internal::TypeId type_id() const noexcept;
+        const type_info& type() const noexcept;
+        const char* type_name() const noexcept;
+        /* iterator */
+        void* begin();
+        void* end();
+        const void* cbegin() const noexcept;
+        const void* cend() const noexcept;
+
+    private:
+        template <class T>
+        void bind_type() noexcept;
+        internal::ArrayBlock* share() const;
+        void unshare();
+        void* advance(const void* ptr, size_t n) const noexcept;
+        size_t distance(const void* last, const void* first) const noexcept;
+
+        template <class T>
+        friend class TypedArray;
+        template <class T>
+        friend class ArraySpan;
+        friend class Table;
+        friend class ArrayView;
+    };
+
+    struct ArrayViewBase {
+        internal::ArrayBlock* block_; // keeps the buffer alive, null for an empty view
+        const internal::ArrayHelper* helper_;
+        size_t elem_size_;
+        const void* first_;
+        const void* last_;
+    };
+
+    /// \brief read-only range of an Array that shares its buffer, made by Array::slice in O(1).
+    ///        The buffer stays alive while any view of it exists, even after the Array is destroyed.
+    ///        An Array that is changed while views exist copies its elements first,
+    ///        so views always see the elements as they were when sliced.
+    class ArrayView : __TYPELESS_ACCESS_LEVEL ArrayViewBase {
+    public:
+        /* constructor */
+        ArrayView() noexcept;
+        ArrayView(const ArrayView& rhs) noexcept;
+        ArrayView(ArrayView&& rhs) noexcept;
+        ArrayView& operator=(const ArrayView& rhs) noexcept;
+        ArrayView& operator=(ArrayView&& rhs) noexcept;
+        ~ArrayView() noexcept;
+        /* conversion */
+        Array to_array() const;
+        template <class T>
+        ArraySpan<const T> span() const;
+        /* getter */
+        template <class T>
+        const T* data() const noexcept;
+        template <class T>
+        const T& at(size_t idx) const noexcept;
+        /* utilities */
+        template <class T, class Callback>
+        void for_each(Callback cb) const;
+        template <class T, class Fn>
+        Array filter(Fn filter_fn) const;
+        template <class T, class TResult = T>
+        TResult join(void (*cb)(const T&, TResult&) = internal::default_join<T, TResult>) const;
+        template <class T, class TResult = T, class F>
+        TResult join(F&& cb) const;
+        template <class T, class TResult, class BinaryOp>
+        TResult reduce(TResult init, BinaryOp&& op) const;
+        ArrayView slice(size_t offset, size_t length) const;
+        bool empty() const noexcept;
+        size_t size() const noexcept;
+        size_t use_count() const noexcept;
+        void swap(ArrayView& right) noexcept;
         /* type */
+        template <typename T>
+        bool has_type() const noexcept;
+        internal::TypeId type_id() const noexcept;
         const type_info& type() const noexcept;
         const char* type_name() const noexcept;
         /* iterator */
-        void* begin() noexcept;
-        void* end() noexcept;
         const void* cbegin() const noexcept;
         const void* cend() const noexcept;
+
+    private:
+        ArrayView(internal::ArrayBlock* block, const internal::ArrayHelper* helper, size_t elem_size,
+                  const void* first, const void* last) noexcept;
+
+        friend class Array;
+    };
+
+    template <class T>
+    struct TypedArrayBase {
+        Array array_;
+    };
+
+    template <class T>
+    struct ArraySpanBase {
+        T* data_;
+        size_t size_;
+    };
+
+    /// \brief Array with the element type fixed at compile time and T* iterators.
+    ///        Converting from an Array takes over its storage, the type is checked once there.
+    template <class T>
+    class TypedArray : __TYPELESS_ACCESS_LEVEL TypedArrayBase<T> {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        /* constructor */
+        TypedArray();
+        TypedArray(ArrayInit<T> init);
+        template <class Iterator>
+        TypedArray(Iterator first, Iterator last);
+        explicit TypedArray(Array arr);
+        /* conversion */
+        const Array& array() const noexcept;
+        Array release() noexcept;
+        /* getter */
+        T* data();
+        const T* data() const noexcept;
+        T& operator[](size_t idx);
+        const T& operator[](size_t idx) const noexcept;
+        T& front();
+        const T& front() const noexcept;
+        T& back();
+        const T& back() const noexcept;
+        /* setter */
+        void push_back(const T& ele);
+        void push_back(T&& ele);
+        template <class... Args>
+        T& emplace_back(Args&&... args);
+        /* utilities */
+        bool empty() const noexcept;
+        size_t size() const noexcept;
+        void resize(size_t new_size);
+        size_t capacity() const noexcept;
+        void reserve(size_t new_capacity);
+        void shrink_to_fit();
+        void swap(TypedArray& right) noexcept;
+        /* iterator */
+        T* begin();
+        T* end();
+        const T* begin() const noexcept;
+        const T* end() const noexcept;
+        const T* cbegin() const noexcept;
+        const T* cend() const noexcept;
+    };
+
+    /// \brief non-owning view of contiguous elements of type T, from an Array, TypedArray or pointer and size.
+    ///        Use ArraySpan<const T> to view a const Array.
+    template <class T>
+    class ArraySpan : __TYPELESS_ACCESS_LEVEL ArraySpanBase<T> {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using pointer = T*;
+        using iterator = T*;
+        /* constructor */
+        ArraySpan() noexcept;
+        ArraySpan(T* data, size_t size) noexcept;
+        explicit ArraySpan(Array& arr);
+        template <class U = T, class = std::enable_if_t<std::is_const<U>::value>>
+        explicit ArraySpan(const Array& arr);
+        ArraySpan(TypedArray<value_type>& arr) noexcept;
+        template <class U = T, class = std::enable_if_t<std::is_const<U>::value>>
+        ArraySpan(const TypedArray<value_type>& arr) noexcept;
+        template <class U, class = std::enable_if_t<std::is_same<const U, T>::value>>
+        ArraySpan(const ArraySpan<U>& span) noexcept;
+        /* getter */
+        T* data() const noexcept;
+        T& operator[](size_t idx) const noexcept;
+        T& front() const noexcept;
+        T& back() const noexcept;
+        /* utilities */
+        bool empty() const noexcept;
+        size_t size() const noexcept;
+        ArraySpan first(size_t count) const noexcept;
+        ArraySpan last(size_t count) const noexcept;
+        ArraySpan subspan(size_t offset, size_t count) const noexcept;
+        ArraySpan subspan(size_t offset) const noexcept;
+        /* iterator */
+        T* begin() const noexcept;
+        T* end() const noexcept;
+
+    private:
+        static T* checked_data(const Array& arr);
+    };
+
+    struct VariantRefBase {
+        const internal::ObjectHelper* helper_;
+        const void* value_;
+    };
+
+    struct VariantArrayBase {
+        std::vector<unsigned char> tags_;                  // index in types_ of each element
+        std::vector<internal::VariantSlot> slots_;         // the value itself, or a pointer to it in chunks_
+        std::vector<const internal::ObjectHelper*> types_; // distinct element types in order of appearance
+        std::vector<std::unique_ptr<char[]>> chunks_;      // arena of values that do not fit in a slot
+        size_t chunk_used_;                                // bytes used of chunks_.back()
+        size_t chunk_size_;                                // bytes allocated for chunks_.back()
+    };
+
+    /// \brief read-only reference to a type-erased value, an element of a VariantArray or a Table cell
+    class VariantRef : __TYPELESS_ACCESS_LEVEL VariantRefBase {
+    public:
+        /* constructor */
+        VariantRef(const internal::ObjectHelper* helper, const void* value) noexcept;
+        /* getter */
+        template <class T>
+        const T& get() const noexcept;
+        const void* data() const noexcept;
+        Object object() const;
+        /* utilities */
+        std::string to_string() const;
+        void append_to(std::string& out) const;
+        /* type */
+        template <typename T>
+        bool has_type() const noexcept;
+        internal::TypeId type_id() const noexcept;
+        const type_info& type() const noexcept;
+        const char* type_name() const noexcept;
+    };
+
+    /// \brief values of mixed types packed contiguously, a compact alternative to an Array of Object.
+    ///        Each element is a 1 byte type tag and an 8 byte slot. Trivially copyable values
+    ///        of up to 8 bytes are stored in the slot, larger ones in an arena the slot points to.
+    class VariantArray : __TYPELESS_ACCESS_LEVEL VariantArrayBase {
+    public:
+        /* constructor */
+        VariantArray() noexcept;
+        VariantArray(ObjectArray init);
+        explicit VariantArray(const Array& objects);
+        VariantArray(const VariantArray& rhs);
+        VariantArray(VariantArray&& rhs) noexcept;
+        VariantArray& operator=(const VariantArray& rhs);
+        VariantArray& operator=(VariantArray&& rhs) noexcept;
+        ~VariantArray() noexcept;
+        /* conversion */
+        Array to_array() const;
+        /* getter */
+        VariantRef operator[](size_t idx) const noexcept;
+        template <class T>
+        const T& get(size_t idx) const noexcept;
+        Object at(size_t idx) const;
+        /* setter */
+        template <class T, class = std::enable_if_t<!std::is_same<std::decay_t<T>, Object>::value>>
+        void push_back(T&& value);
+        void push_back(const Object& obj);
+        /* utilities */
+        template <class F>
+        void visit(F f) const;
+        template <class T, class F>
+        void for_each(F f) const;
+        template <class T>
+        size_t count() const noexcept;
+        bool empty() const noexcept;
+        size_t size() const noexcept;
+        void reserve(size_t n);
+        void clear() noexcept;
+        void swap(VariantArray& right) noexcept;
+        /* type */
+        template <typename T>
+        bool has_type(size_t idx) const noexcept;
+        const type_info& type(size_t idx) const noexcept;
+
+    private:
+        template <class T>
+        int find_tag() const noexcept;
+        unsigned char tag_of(const internal::ObjectHelper* helper);
+        const void* value(size_t idx) const noexcept;
+        void* arena_allocate(size_t size, size_t align);
+        template <class Construct>
+        void emplace(const internal::ObjectHelper* helper, Construct construct);
+    };
+
+    struct TableRowBase {
+        const Table* table_;
+        size_t index_;
+    };
+
+    struct TableBase {
+        std::vector<string> names_;
+        std::vector<Array> columns_;
+        std::vector<const internal::ObjectHelper*> types_; // element type of each column, for cell access
+        size_t rows_;
+    };
+
+    /// \brief lazy view of one row of a Table, cells are only read when accessed
+    class TableRow : __TYPELESS_ACCESS_LEVEL TableRowBase {
+    public:
+        /* constructor */
+        TableRow(const Table* table, size_t index) noexcept;
+        /* getter */
+        VariantRef operator[](size_t column) const;
+        VariantRef operator[](const string& name) const;
+        template <class T>
+        const T& get(const string& name) const;
+        /* utilities */
+        size_t index() const noexcept;
+        size_t size() const noexcept;
+        Array to_array() const;
+    };
+
+    /// \brief named Array columns of equal length, a struct-of-arrays record batch.
+    ///        Columns are plain Arrays so scans use the Array algorithms directly.
+    class Table : __TYPELESS_ACCESS_LEVEL TableBase {
+    public:
+        /* constructor */
+        Table() noexcept;
+        /* columns */
+        template <class T>
+        void add_column(const string& name);
+        template <class T>
+        void add_column(const string& name, Array column);
+        const Array& column(size_t idx) const noexcept;
+        const Array& column(const string& name) const;
+        template <class T>
+        ArraySpan<T> span(const string& name);
+        template <class T>
+        ArraySpan<const T> span(const string& name) const;
+        const string& column_name(size_t idx) const noexcept;
+        size_t column_index(const string& name) const;
+        bool has_column(const string& name) const noexcept;
+        size_t columns() const noexcept;
+        /* rows */
+        void append_row(ObjectArray values);
+        TableRow row(size_t idx) const noexcept;
+        VariantRef cell(size_t row, size_t column) const noexcept;
+        size_t rows() const noexcept;
+        bool empty() const noexcept;
+        void reserve(size_t rows);
+        void clear() noexcept;
+    };
+
+    /// \brief Object whose value is shared between copies.
+    ///        Copies only increase a reference count, a private copy of the value
+    ///        is made when a mutable reference is requested from a shared value.
+    class SharedObject : __TYPELESS_ACCESS_LEVEL SharedObjectBase {
+    public:
+        /* constructor */
+        SharedObject() noexcept;
+        ~SharedObject() noexcept;
+        template <class T, class = std::enable_if_t<!std::is_same<std::decay_t<T>, SharedObject>::value &&
+                                                    !std::is_same<std::decay_t<T>, Object>::value>>
+        SharedObject(T&& value);
+        SharedObject(Object obj);
+        SharedObject(const SharedObject& rhs) noexcept;
+        SharedObject(SharedObject&& rhs) noexcept;
+        SharedObject& operator=(const SharedObject& rhs) noexcept;
+        SharedObject& operator=(SharedObject&& rhs) noexcept;
+        /* getter */
+        template <class T>
+        T& get();
+        template <class T>
+        const T& get() const;
+        const Object& object() const noexcept;
+        /* utilities */
+        void detach();
+        bool unique() const noexcept;
+        size_t use_count() const noexcept;
+        bool empty() const noexcept;
+        void reset() noexcept;
+        void swap(SharedObject& right) noexcept;
+        std::string to_string() const;
+        /* type */
+        template <typename T>
+        bool has_type() const noexcept;
+        internal::TypeId type_id() const noexcept;
+        const type_info& type() const noexcept;
+        const char* type_name() const noexcept;
+    };
+
+    /// \brief fixed set of threads that run parallel Array algorithms.
+    ///        Every thread owns a work-stealing deque, idle threads steal from the others.
+    ///        The thread that starts a parallel loop runs tasks too,
+    ///        so a pool of n threads starts n - 1 workers and a pool of 1 runs everything inline.
+    class ThreadPool : __TYPELESS_ACCESS_LEVEL ThreadPoolBase {
+    public:
+        /* constructor */
+        explicit ThreadPool(size_t n_threads = std::thread::hardware_concurrency());
+        ~ThreadPool() noexcept;
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        /* utilities */
+        size_t size() const noexcept;
+        size_t chunk_size() const noexcept;
+        void set_chunk_size(size_t n_bytes) noexcept;
+        template <class F>
+        void parallel_for(size_t n, F&& fn);
+        template <class T, class F>
+        void parallel_chunks(T* data, size_t n, F&& fn);
+
+    private:
+        void push(const internal::PoolTask* tasks, size_t n);
+        bool run_one(size_t queue_index);
+        void worker_main(size_t queue_index);
+        size_t current_queue() const noexcept;
     };
 
 #pragma region ObjectImpl
-    inline Object::Object() : ObjectBase{nullptr, nullptr} {
+    inline Object::Object() : ObjectBase{nullptr, nullptr, {}} {
     }
     inline Object::~Object() noexcept {
         destroy();
         invalidate();
     }
-    template <class T>
-    Object::Object(const T& obj) : ObjectBase() {
+    template <class T, class>
+    Object::Object(T&& obj) : ObjectBase{nullptr, nullptr, {}} {
+        using U = std::decay_t<T>;
+        value_ = internal::ObjectHelperTable<U>::emplace(&storage_, std::forward<T>(obj));
+        helper_ = internal::GetObjectHelper<U>();
+    }
+    template <class T, class... Args>
+    Object::Object(in_place_type_t<T>, Args&&... args) : ObjectBase{nullptr, nullptr, {}} {
+        value_ = internal::ObjectHelperTable<T>::emplace(&storage_, std::forward<Args>(args)...);
         helper_ = internal::GetObjectHelper<T>();
-        value_ = helper_->make_copy(&obj);
     }
-    inline Object::Object(const Object& rhs) : ObjectBase(rhs) {
+    inline Object::Object(const Object& rhs) : ObjectBase{rhs.helper_, nullptr, {}} {
         if (helper_ != nullptr) {
-            value_ = helper_->make_copy(value_);
+            value_ = helper_->make_copy(&storage_, rhs.value_);
         }
     }
-    inline Object::Object(Object&& rhs) noexcept : ObjectBase(rhs) {
+    inline Object::Object(Object&& rhs) noexcept : ObjectBase{rhs.helper_, rhs.value_, {}} {
+        if (rhs.is_inline()) {
+            value_ = helper_->relocate(&storage_, rhs.value_);
+        }
         rhs.invalidate();
     }
 
     inline Object& Object::operator=(const Object& rhs) {
+        assign(rhs);
+        return *this;
+    }
+
+    inline Object& Object::operator=(Object&& rhs) noexcept {
         if (this == &rhs) {
             return *this;
         }
         destroy();
         helper_ = rhs.helper_;
-        if (helper_ != nullptr) {
-            value_ = helper_->make_copy(rhs.value_); // construct an object
+        value_ = rhs.value_;
+        if (rhs.is_inline()) {
+            value_ = helper_->relocate(&storage_, rhs.value_);
         }
-        return *this;
-    }
-
-    inline Object& Object::operator=(Object&& rhs) noexcept {
-        destroy();
-        static_cast<ObjectBase&>(*this) = rhs;
         rhs.invalidate();
         return *this;
     }
@@ -249,12 +1053,14 @@ namespace typeless {
     template <class T>
     bool operator==(const Object& obj, const T& v) {
         assert(obj.helper_ != nullptr);
-        return obj.type() == typeid(T) && obj.get<T>() == v;
+        return obj.has_type<T>() && obj.get<T>() == v;
     }
 
+    /// \brief values of different arithmetic types are equal if they have the same value
     inline bool operator==(const Object& l, const Object& r) {
         assert(l.helper_ != nullptr && r.helper_ != nullptr);
-        return l.type() == r.type() && l.helper_->equal(l.value_, r.value_);
+        auto equal = internal::equal_function(l.helper_, r.helper_);
+        return equal != nullptr && equal(l.value_, r.value_);
     }
 
     template <class T>
@@ -262,62 +1068,110 @@ namespace typeless {
         return !(obj == v);
     }
 
+    /// \brief values of different arithmetic types are compared by value,
+    ///        in at least double precision if one is floating point, other types must match
     inline bool operator<(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return false;
-        }
-        return l.helper_->less(l.value_, r.value_);
+        auto less = internal::less_function(l.helper_, r.helper_);
+        return less != nullptr && less(l.value_, r.value_);
     }
 
     inline bool operator>(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return false;
-        }
-        return !l.helper_->less(l.value_, r.value_);
+        return r < l;
     }
 
+    /// \brief false if either side is NaN, like the built-in operator
     inline bool operator<=(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return false;
-        }
-        return l.helper_->less(l.value_, r.value_) ||
-               l.helper_->equal(l.value_, r.value_);
+        auto less = internal::less_function(l.helper_, r.helper_);
+        auto equal = internal::equal_function(l.helper_, r.helper_);
+        return less != nullptr && (less(l.value_, r.value_) || equal(l.value_, r.value_));
     }
 
     inline bool operator>=(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return false;
-        }
-        return !l.helper_->less(l.value_, r.value_) ||
-               l.helper_->equal(l.value_, r.value_);
+        return r <= l;
     }
 
+    /// \brief values of different arithmetic types are promoted like
+    ///        built-in operators do, other types must match
     inline Object operator+(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return Object();
+        if (l.helper_ != nullptr && internal::same_type(l.helper_, r.helper_)) {
+            return l.helper_->sum(l.value_, r.value_);
         }
-        return l.helper_->sum(l.value_, r.value_);
+        auto ops = internal::promoted_ops(l.helper_, r.helper_);
+        return ops == nullptr ? Object() : ops->sum(l.value_, r.value_);
     }
 
     inline Object operator-(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return Object();
+        if (l.helper_ != nullptr && internal::same_type(l.helper_, r.helper_)) {
+            return l.helper_->difference(l.value_, r.value_);
         }
-        return l.helper_->difference(l.value_, r.value_);
+        auto ops = internal::promoted_ops(l.helper_, r.helper_);
+        return ops == nullptr ? Object() : ops->difference(l.value_, r.value_);
     }
 
     inline Object operator*(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return Object();
+        if (l.helper_ != nullptr && internal::same_type(l.helper_, r.helper_)) {
+            return l.helper_->product(l.value_, r.value_);
         }
-        return l.helper_->product(l.value_, r.value_);
+        auto ops = internal::promoted_ops(l.helper_, r.helper_);
+        return ops == nullptr ? Object() : ops->product(l.value_, r.value_);
     }
 
     inline Object operator/(const Object& l, const Object& r) {
-        if (l.type() != r.type()) {
-            return Object();
+        if (l.helper_ != nullptr && internal::same_type(l.helper_, r.helper_)) {
+            return l.helper_->quotient(l.value_, r.value_);
+        }
+        auto ops = internal::promoted_ops(l.helper_, r.helper_);
+        return ops == nullptr ? Object() : ops->quotient(l.value_, r.value_);
+    }
+
+    /// \brief compute in place. Like built-in compound assignment the value keeps
+    ///        its type, an Object of unrelated type makes the result empty
+    inline Object& Object::operator+=(const Object& rhs) {
+        if (helper_ != nullptr && internal::same_type(helper_, rhs.helper_)) {
+            helper_->sum_assign(value_, rhs.value_);
+        } else if (auto ops = internal::promoted_ops(helper_, rhs.helper_)) {
+            ops->sum_assign(value_, rhs.value_);
+        } else {
+            destroy();
+            invalidate();
+        }
+        return *this;
+    }
+
+    inline Object& Object::operator-=(const Object& rhs) {
+        if (helper_ != nullptr && internal::same_type(helper_, rhs.helper_)) {
+            helper_->difference_assign(value_, rhs.value_);
+        } else if (auto ops = internal::promoted_ops(helper_, rhs.helper_)) {
+            ops->difference_assign(value_, rhs.value_);
+        } else {
+            destroy();
+            invalidate();
+        }
+        return *this;
+    }
+
+    inline Object& Object::operator*=(const Object& rhs) {
+        if (helper_ != nullptr && internal::same_type(helper_, rhs.helper_)) {
+            helper_->product_assign(value_, rhs.value_);
+        } else if (auto ops = internal::promoted_ops(helper_, rhs.helper_)) {
+            ops->product_assign(value_, rhs.value_);
+        } else {
+            destroy();
+            invalidate();
+        }
+        return *this;
+    }
+
+    inline Object& Object::operator/=(const Object& rhs) {
+        if (helper_ != nullptr && internal::same_type(helper_, rhs.helper_)) {
+            helper_->quotient_assign(value_, rhs.value_);
+        } else if (auto ops = internal::promoted_ops(helper_, rhs.helper_)) {
+            ops->quotient_assign(value_, rhs.value_);
+        } else {
+            destroy();
+            invalidate();
         }
-        return l.helper_->quotient(l.value_, r.value_);
+        return *this;
     }
 
     inline void* Object::data() const noexcept { return value_; }
@@ -332,13 +1186,48 @@ namespace typeless {
         return *static_cast<const T*>(value_);
     }
 
+    /// \brief set value to [val], assigning over the current value if it has the same type.
+    /// \return true if existing storage is reused
     template <class T>
-    void Object::set(const T& val) {
-        if (helper_ != nullptr) {
-            helper_->destroy_deallocate(value_);
+    bool Object::set(T&& val) {
+        using U = std::decay_t<T>;
+        using Assignable = std::is_assignable<U&, T&&>;
+        if (Assignable::value && has_type<U>()) {
+            internal::assign_value<U>(value_, std::forward<T>(val), Assignable{});
+            return true;
+        }
+        emplace<U>(std::forward<T>(val));
+        return false;
+    }
+
+    /// \brief copy [rhs], assigning over the current value if it has the same type.
+    /// \return true if existing storage is reused
+    inline bool Object::assign(const Object& rhs) {
+        if (this == &rhs) {
+            return true;
+        }
+        if (helper_ != nullptr && helper_->copy_assign != nullptr &&
+            internal::same_type(helper_, rhs.helper_)) {
+            helper_->copy_assign(value_, rhs.value_);
+            return true;
+        }
+        destroy();
+        invalidate();
+        if (rhs.helper_ != nullptr) {
+            value_ = rhs.helper_->make_copy(&storage_, rhs.value_); // construct an object
+            helper_ = rhs.helper_;
         }
+        return false;
+    }
+
+    /// \brief destroy current value and construct a T from [args] in place
+    template <class T, class... Args>
+    T& Object::emplace(Args&&... args) {
+        destroy();
+        invalidate();
+        value_ = internal::ObjectHelperTable<T>::emplace(&storage_, std::forward<Args>(args)...);
         helper_ = internal::GetObjectHelper<T>();
-        value_ = helper_->make_copy(&val);
+        return *static_cast<T*>(value_);
     }
 
     inline Object Object::clone() const { return *this; }
@@ -359,54 +1248,108 @@ namespace typeless {
         value_ = nullptr;
     }
 
-    inline void Object::swap(Object& right) noexcept { std::swap(*this, right); }
+    inline void Object::swap(Object& right) noexcept {
+        Object tmp(std::move(right));
+        right = std::move(*this);
+        *this = std::move(tmp);
+    }
 
     inline std::string Object::to_string() const {
+        std::string out;
+        append_to(out);
+        return out;
+    }
+
+    /// \brief append string form of value to [out] without a temporary string
+    inline void Object::append_to(std::string& out) const {
         if (helper_ == nullptr) {
-            return "null";
+            out += "null";
+            return;
+        }
+        helper_->append_to(out, value_);
+    }
+
+    /// \brief hash of type and value, consistent with operator==
+    ///        arithmetic values are hashed without type since mixed types compare equal
+    inline size_t Object::hash() const {
+        if (helper_ == nullptr) {
+            return 0;
+        }
+        if (helper_->arith_index != 0) {
+            return helper_->hash(value_);
         }
-        return helper_->to_string(value_);
+        return internal::hash_combine(static_cast<size_t>(helper_->type_id), helper_->hash(value_));
+    }
+
+    /// \brief true if value is stored inside the object rather than on heap
+    inline bool Object::is_inline() const noexcept {
+        return value_ != nullptr && value_ == static_cast<const void*>(&storage_);
     }
 
     template <typename T>
     bool Object::has_type() const noexcept {
-        return type() == typeid(T);
+        return internal::has_type<T>(helper_);
+    }
+
+    inline internal::TypeId Object::type_id() const noexcept {
+        if (helper_ == nullptr) {
+            return internal::type_id<std::nullptr_t>();
+        }
+        return helper_->type_id;
     }
 
     inline const type_info& Object::type() const noexcept {
         if (helper_ == nullptr) {
             return typeid(std::nullptr_t);
         }
-        return *helper_->type();
+        return *helper_->type;
     }
 
     inline const char* Object::type_name() const noexcept {
         if (helper_ == nullptr) {
             return "void";
         }
-        return helper_->type()->name();
+        return helper_->type->name();
     }
 #pragma endregion ObjectImpl
 
 #pragma region ArrayImpl
-    inline Array::Array() : ArrayBase{nullptr, nullptr, nullptr} {
+    namespace internal {
+        /// \brief buffer of an Array shared with its ArrayViews, freed with the last reference
+        struct ArrayBlock {
+            std::atomic<size_t> refs;
+            const ArrayHelper* helper;
+            void* arr;
+            size_t size;
+            size_t capacity;
+        };
+
+        inline void release(ArrayBlock* block) noexcept {
+            if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                block->helper->destroy_deallocate(block->arr, block->size, block->capacity);
+                delete block;
+            }
+        }
+    } // namespace internal
+
+    inline Array::Array() : ArrayBase{nullptr, 1, nullptr, nullptr, nullptr, nullptr, false} {
     }
 
     template <class T>
     Array::Array(ArrayInit<T> init) : ArrayBase() {
-        helper_ = internal::GetArrayHelper<T>();
+        bind_type<T>();
         auto n = init.size();
         arr_ = helper_->make_copy(init.begin(), n);
-        end_ = helper_->advance(arr_, n);
+        end_ = cap_ = advance(arr_, n);
     }
 
     template <class Iterator>
     Array::Array(Iterator first, Iterator last) : ArrayBase() {
         using T = std::decay_t<decltype(*first)>;
-        helper_ = internal::GetArrayHelper<T>();
+        bind_type<T>();
         auto n = last - first;
         arr_ = helper_->allocate(n);
-        end_ = helper_->advance(arr_, n);
+        end_ = cap_ = advance(arr_, n);
         T* p = static_cast<T*>(arr_);
         while(n--) {
             internal::copy_construct_at(p, *first);
@@ -415,26 +1358,25 @@ namespace typeless {
         }
     }
 
+    /// \brief copy elements, or share the buffer in O(1) if [rhs] is in copy on write mode
     inline Array::Array(const Array& rhs) : ArrayBase(rhs) {
+        block_ = nullptr;
+        if (cow_ && arr_ != nullptr) {
+            block_ = rhs.share();
+            return;
+        }
         if (helper_) {
-            auto n = helper_->distance(end_, arr_);
+            auto n = distance(end_, arr_);
             arr_ = helper_->make_copy(arr_, n);
-            end_ = helper_->advance(arr_, n);
+            end_ = cap_ = advance(arr_, n);
         }
     }
 
     inline Array::Array(Array&& rhs) noexcept : ArrayBase(rhs) { rhs.invalidate(); }
 
     inline Array& Array::operator=(const Array& rhs) {
-        if (this == &rhs) {
-            return *this;
-        }
-        destroy();
-        helper_ = rhs.helper_;
-        if (helper_ != nullptr) {
-            auto n = helper_->distance(rhs.end_, rhs.arr_);
-            arr_ = helper_->make_copy(rhs.arr_, n);
-            end_ = helper_->advance(arr_, n);
+        if (this != &rhs) {
+            Array(rhs).swap(*this);
         }
         return *this;
     }
@@ -451,40 +1393,91 @@ namespace typeless {
         invalidate();
     }
 
+    inline bool operator==(const Array& l, const Array& r) {
+        if (!internal::same_type(l.helper_, r.helper_)) {
+            return false;
+        }
+        if (l.helper_ == nullptr) {
+            return true;
+        }
+        size_t n = l.size();
+        return n == r.size() && l.helper_->equal(l.arr_, r.arr_, n);
+    }
+
+    inline bool operator!=(const Array& l, const Array& r) {
+        return !(l == r);
+    }
+
     template <class T>
     const T* Array::data() const noexcept {
         return static_cast<const T*>(arr_);
     }
 
     template <class T>
-    T* Array::data() noexcept {
+    T* Array::data() {
+        unshare();
         return static_cast<T*>(arr_);
     }
 
     template <class T>
     T& Array::at(size_t idx) {
-        assert(idx < size());
+        assert(has_type<T>() && idx < size());
+        unshare();
         return static_cast<T*>(arr_)[idx];
     }
 
     template <class T>
     T Array::at(size_t idx) const {
-        assert(idx < size());
+        assert(has_type<T>() && idx < size());
         return static_cast<const T*>(arr_)[idx];
     }
 
     template <class T>
     void Array::set(size_t off, const T& ele) {
-        assert(off < size());
-        void* ptr = helper_->advance(arr_, off);
-        helper_->destruct(ptr);
+        assert(has_type<T>() && off < size());
+        unshare();
+        T* ptr = static_cast<T*>(arr_) + off;
+        ptr->~T();
         internal::copy_construct_at(ptr, ele);
     }
 
+    /// \brief append a copy of [ele], the array takes type of [ele] if it has none
+    template <class T>
+    void Array::push_back(T&& ele) {
+        emplace_back<std::decay_t<T>>(std::forward<T>(ele));
+    }
+
+    /// \brief construct element at the end, amortized O(1) by geometric growth
+    template <class T, class... Args>
+    T& Array::emplace_back(Args&&... args) {
+        if (helper_ == nullptr) {
+            bind_type<T>();
+        }
+        assert(has_type<T>());
+        if (block_ != nullptr) {
+            // [args] may refer to an element of the shared buffer, which stays alive while copying
+            T value(std::forward<Args>(args)...);
+            unshare();
+            return emplace_back<T>(std::move_if_noexcept(value));
+        }
+        if (end_ == cap_) {
+            // [args] may refer to an element of this array, construct it before reallocating
+            T value(std::forward<Args>(args)...);
+            reserve(std::max<size_t>(capacity() * 2, 4));
+            ::new (end_) T(std::move_if_noexcept(value));
+        } else {
+            ::new (end_) T(std::forward<Args>(args)...);
+        }
+        T* ptr = static_cast<T*>(end_);
+        end_ = ptr + 1;
+        return *ptr;
+    }
+
     template <class T>
     void Array::set_type() {
         destroy();
-        helper_ = internal::GetArrayHelper<T>();
+        invalidate();
+        bind_type<T>();
     }
 
     template <class T, class Callback>
@@ -497,65 +1490,469 @@ namespace typeless {
         }
     }
 
+    /// \brief copy of elements satisfying [filter_fn], capacity of the result is its size().
+    ///        [filter_fn] is called once per element.
     template <class T, class Fn>
     Array Array::filter(Fn filter_fn) const {
         if (arr_ == nullptr)
             return *this;
+        assert(has_type<T>());
+        const T* first = static_cast<const T*>(arr_);
         size_t n = size();
+        std::unique_ptr<bool[]> keep(new bool[n]);
+        size_t kept = internal::mark_if(first, n, keep.get(), filter_fn);
         Array filtered;
         filtered.helper_ = helper_;
-        filtered.arr_ = filtered.helper_->allocate(n);
-        filtered.end_ = filtered.helper_->advance(filtered.arr_, n);
+        filtered.elem_size_ = elem_size_;
+        filtered.reserve(kept);
+        filtered.end_ = internal::copy_marked(first, n, keep.get(), static_cast<T*>(filtered.arr_));
+        return filtered;
+    }
 
-        T* p = static_cast<T*>(arr_);
-        T* p_filtered = static_cast<T*>(filtered.arr_);
-        while (p != end_) {
-            if (filter_fn(*p)) {
-                helper_->construct(p_filtered, p);
-                ++p_filtered;
+    /// \brief remove elements satisfying [pred] in place without allocating,
+    ///        returns number of removed elements
+    template <class T, class Pred>
+    size_t Array::erase_if(Pred pred) {
+        return retain<T>([&pred](const T& value) { return !pred(value); });
+    }
+
+    /// \brief keep only elements satisfying [pred] in place without allocating,
+    ///        returns number of removed elements
+    template <class T, class Pred>
+    size_t Array::retain(Pred pred) {
+        if (arr_ == nullptr)
+            return 0;
+        assert(has_type<T>());
+        unshare();
+        T* first = static_cast<T*>(arr_);
+        T* last = static_cast<T*>(end_);
+        T* new_end = internal::compact_if(first, last, first, pred);
+        internal::destroy_n(new_end, last - new_end);
+        end_ = new_end;
+        return last - new_end;
+    }
+
+    template <class T, class TResult>
+    TResult Array::join(void (*cb)(const T&, TResult&)) const {
+        return join<T, TResult, void (*)(const T&, TResult&)>(std::move(cb));
+    }
+
+    /// \brief fold elements into a default constructed TResult with cb(element, result).
+    ///        [cb] can be any callable, it is invoked directly so the loop can be inlined.
+    template <class T, class TResult, class F>
+    TResult Array::join(F&& cb) const {
+        TResult result{};
+        const T* end = static_cast<const T*>(end_);
+        for (const T* ptr = static_cast<const T*>(arr_); ptr != end; ++ptr) {
+            cb(*ptr, result);
+        }
+        return result;
+    }
+
+    /// \brief left fold like std::accumulate, the accumulator is moved into each op(acc, element) call
+    template <class T, class TResult, class BinaryOp>
+    TResult Array::reduce(TResult init, BinaryOp&& op) const {
+        const T* end = static_cast<const T*>(end_);
+        for (const T* ptr = static_cast<const T*>(arr_); ptr != end; ++ptr) {
+            init = op(std::move(init), *ptr);
+        }
+        return init;
+    }
+
+    /// \brief replace every element with f(element)
+    template <class T, class F>
+    void Array::transform(F f) {
+        unshare();
+        T* end = static_cast<T*>(end_);
+        for (T* ptr = static_cast<T*>(arr_); ptr != end; ++ptr) {
+            *ptr = f(static_cast<const T&>(*ptr));
+        }
+    }
+
+    /// \brief new Array of f(element) for every element, constructed in place in storage allocated once.
+    ///        Element type is [U] if given, otherwise the decayed result type of [f].
+    template <class T, class U, class F>
+    Array Array::map(F&& f) const {
+        using R = internal::MapResult<U, F, T>;
+        Array mapped;
+        mapped.set_type<R>();
+        if (arr_ == end_)
+            return mapped;
+        assert(has_type<T>());
+        size_t n = size();
+        mapped.reserve(n);
+        R* out = static_cast<R*>(mapped.arr_);
+        internal::map_n(static_cast<const T*>(arr_), n, out, f);
+        mapped.end_ = out + n;
+        return mapped;
+    }
+
+    /// \brief sort ascending. Integers, float and double are sorted with an LSD radix sort,
+    ///        other types with std::sort and operator<.
+    template <class T>
+    void Array::sort() {
+        if (arr_ == end_)
+            return;
+        assert(has_type<T>());
+        unshare();
+        internal::radix_sort(static_cast<T*>(arr_), size());
+    }
+
+    template <class T, class Compare>
+    void Array::sort(Compare comp) {
+        assert(empty() || has_type<T>());
+        unshare();
+        std::sort(static_cast<T*>(arr_), static_cast<T*>(end_), comp);
+    }
+
+    /// \brief sort ascending keeping the order of equal elements, radix sort is stable already
+    template <class T>
+    void Array::stable_sort() {
+        if (arr_ == end_)
+            return;
+        assert(has_type<T>());
+        unshare();
+        internal::stable_sort(static_cast<T*>(arr_), size());
+    }
+
+    template <class T, class Compare>
+    void Array::stable_sort(Compare comp) {
+        assert(empty() || has_type<T>());
+        unshare();
+        std::stable_sort(static_cast<T*>(arr_), static_cast<T*>(end_), comp);
+    }
+
+    /// \brief sort the smallest [middle] elements into [0, middle)
+    template <class T, class Compare>
+    void Array::partial_sort(size_t middle, Compare comp) {
+        assert((empty() || has_type<T>()) && middle <= size());
+        unshare();
+        T* first = static_cast<T*>(arr_);
+        std::partial_sort(first, first + middle, static_cast<T*>(end_), comp);
+    }
+
+    /// \brief put the element that a full sort would place at [nth] there, smaller ones before it
+    template <class T, class Compare>
+    void Array::nth_element(size_t nth, Compare comp) {
+        assert((empty() || has_type<T>()) && nth <= size());
+        unshare();
+        T* first = static_cast<T*>(arr_);
+        std::nth_element(first, first + nth, static_cast<T*>(end_), comp);
+    }
+
+    /// \brief index of first element not less than [value] in a sorted array
+    template <class T, class Compare>
+    size_t Array::lower_bound(const T& value, Compare comp) const {
+        assert(empty() || has_type<T>());
+        const T* first = static_cast<const T*>(arr_);
+        return std::lower_bound(first, static_cast<const T*>(end_), value, comp) - first;
+    }
+
+    /// \brief index of first element greater than [value] in a sorted array
+    template <class T, class Compare>
+    size_t Array::upper_bound(const T& value, Compare comp) const {
+        assert(empty() || has_type<T>());
+        const T* first = static_cast<const T*>(arr_);
+        return std::upper_bound(first, static_cast<const T*>(end_), value, comp) - first;
+    }
+
+    template <class T, class Compare>
+    bool Array::binary_search(const T& value, Compare comp) const {
+        assert(empty() || has_type<T>());
+        return std::binary_search(static_cast<const T*>(arr_), static_cast<const T*>(end_), value, comp);
+    }
+
+    /// \brief for_each on [pool], [cb] is called concurrently and in no particular order
+    template <class T, class Callback>
+    void Array::for_each(ThreadPool& pool, Callback cb) const {
+        if (arr_ == end_)
+            return;
+        pool.parallel_chunks(static_cast<T*>(arr_), size(), [&cb](T* first, T* last) {
+            for (; first != last; ++first) {
+                cb(*first);
             }
-            ++p;
+        });
+    }
+
+    /// \brief filter on [pool], order of elements is kept.
+    ///        [filter_fn] is called once per element, concurrently.
+    template <class T, class Fn>
+    Array Array::filter(ThreadPool& pool, Fn filter_fn) const {
+        if (arr_ == nullptr)
+            return *this;
+        assert(has_type<T>());
+        const T* data = static_cast<const T*>(arr_);
+        size_t n = size();
+        internal::ChunkLayout layout(data, n, sizeof(T), pool.chunk_size());
+        std::unique_ptr<bool[]> keep(new bool[n]);
+        std::vector<size_t> offsets(layout.count() + 1);
+        pool.parallel_for(layout.count(), [&](size_t chunk) {
+            size_t kept = 0;
+            for (size_t i = layout.begin(chunk); i != layout.end(chunk); ++i) {
+                keep[i] = static_cast<bool>(filter_fn(data[i]));
+                kept += keep[i];
+            }
+            offsets[chunk + 1] = kept;
+        });
+        for (size_t chunk = 0; chunk < layout.count(); ++chunk) {
+            offsets[chunk + 1] += offsets[chunk];
         }
-        if (p_filtered != filtered.end_) {
-            T default_value{};
-            do {
-                helper_->construct(p_filtered, &default_value);
-                ++p_filtered;
-            } while (p_filtered != filtered.end_);
+        Array filtered;
+        filtered.helper_ = helper_;
+        filtered.elem_size_ = elem_size_;
+        filtered.reserve(offsets.back());
+        T* out = static_cast<T*>(filtered.arr_);
+        std::unique_ptr<bool[]> copied(new bool[layout.count()]());
+        try {
+            pool.parallel_for(layout.count(), [&](size_t chunk) {
+                T* first = out + offsets[chunk];
+                T* last = first;
+                try {
+                    for (size_t i = layout.begin(chunk); i != layout.end(chunk); ++i) {
+                        if (keep[i]) {
+                            internal::copy_construct_at(last, data[i]);
+                            ++last;
+                        }
+                    }
+                } catch (...) {
+                    internal::destroy_n(first, last - first);
+                    throw;
+                }
+                copied[chunk] = true;
+            });
+        } catch (...) {
+            for (size_t chunk = 0; chunk < layout.count(); ++chunk) {
+                if (copied[chunk]) {
+                    internal::destroy_n(out + offsets[chunk], offsets[chunk + 1] - offsets[chunk]);
+                }
+            }
+            throw;
         }
+        filtered.end_ = out + offsets.back();
         return filtered;
     }
 
-    template <class T, class TResult>
-    TResult Array::join(void (*cb)(const T&, TResult&)) {
-        if (arr_ == nullptr)
-            return {};
-        TResult result{};
-        T* ptr = static_cast<T*>(arr_);
-        while (ptr < end_) {
-            cb(*ptr++, result);
+    /// \brief reduce on [pool] where [op] also combines partial results
+    template <class T, class TResult, class BinaryOp>
+    TResult Array::reduce(ThreadPool& pool, TResult init, BinaryOp op) const {
+        return reduce<T>(pool, std::move(init), op, op);
+    }
+
+    /// \brief reduce on [pool]. Every chunk is folded with [op] starting from a copy of [init],
+    ///        then partial results are folded in order with [combine].
+    ///        [init] must be an identity of [combine], and [combine] must be associative.
+    template <class T, class TResult, class BinaryOp, class Combine>
+    TResult Array::reduce(ThreadPool& pool, TResult init, BinaryOp op, Combine combine) const {
+        if (arr_ == end_)
+            return init;
+        const T* data = static_cast<const T*>(arr_);
+        internal::ChunkLayout layout(data, size(), sizeof(T), pool.chunk_size());
+        std::vector<TResult> partials(layout.count(), init);
+        pool.parallel_for(layout.count(), [&](size_t chunk) {
+            TResult acc = std::move(partials[chunk]);
+            for (size_t i = layout.begin(chunk); i != layout.end(chunk); ++i) {
+                acc = op(std::move(acc), data[i]);
+            }
+            partials[chunk] = std::move(acc);
+        });
+        for (TResult& partial : partials) {
+            init = combine(std::move(init), std::move(partial));
         }
-        return result;
+        return init;
+    }
+
+    /// \brief transform on [pool], [f] is called concurrently
+    template <class T, class F>
+    void Array::transform(ThreadPool& pool, F f) {
+        if (arr_ == end_)
+            return;
+        unshare();
+        pool.parallel_chunks(static_cast<T*>(arr_), size(), [&f](T* first, T* last) {
+            for (; first != last; ++first) {
+                *first = f(static_cast<const T&>(*first));
+            }
+        });
+    }
+
+    /// \brief map on [pool], [f] is called concurrently
+    template <class T, class U, class F>
+    Array Array::map(ThreadPool& pool, F f) const {
+        using R = internal::MapResult<U, F, T>;
+        Array mapped;
+        mapped.set_type<R>();
+        if (arr_ == end_)
+            return mapped;
+        assert(has_type<T>());
+        const T* data = static_cast<const T*>(arr_);
+        size_t n = size();
+        mapped.reserve(n);
+        R* out = static_cast<R*>(mapped.arr_);
+        internal::ChunkLayout layout(data, n, sizeof(T), pool.chunk_size());
+        std::unique_ptr<bool[]> mapped_chunks(new bool[layout.count()]());
+        try {
+            pool.parallel_for(layout.count(), [&](size_t chunk) {
+                size_t first = layout.begin(chunk);
+                internal::map_n(data + first, layout.end(chunk) - first, out + first, f);
+                mapped_chunks[chunk] = true;
+            });
+        } catch (...) {
+            for (size_t chunk = 0; chunk < layout.count(); ++chunk) {
+                if (mapped_chunks[chunk]) {
+                    internal::destroy_n(out + layout.begin(chunk), layout.end(chunk) - layout.begin(chunk));
+                }
+            }
+            throw;
+        }
+        mapped.end_ = out + n;
+        return mapped;
+    }
+
+    /// \brief sort on [pool]: one run per thread is sorted in parallel,
+    ///        then neighbouring runs are merged pairwise in parallel rounds
+    template <class T, class Compare>
+    void Array::sort(ThreadPool& pool, Compare comp) {
+        if (arr_ == end_)
+            return;
+        assert(has_type<T>());
+        unshare();
+        T* data = static_cast<T*>(arr_);
+        size_t n = size();
+        size_t n_runs = std::min(pool.size(), std::max<size_t>(1, n / 1024));
+        auto run_begin = [&](size_t run) { return data + n * std::min(run, n_runs) / n_runs; };
+        pool.parallel_for(n_runs, [&](size_t run) { std::sort(run_begin(run), run_begin(run + 1), comp); });
+        for (size_t width = 1; width < n_runs; width *= 2) {
+            size_t n_merges = (n_runs + 2 * width - 1) / (2 * width);
+            pool.parallel_for(n_merges, [&](size_t merge) {
+                size_t first = merge * 2 * width;
+                if (first + width < n_runs) {
+                    std::inplace_merge(run_begin(first), run_begin(first + width), run_begin(first + 2 * width), comp);
+                }
+            });
+        }
+    }
+
+    /// \brief sum of elements, integers are summed as 64-bit with wrap-around.
+    ///        Integer results are identical on every instruction set,
+    ///        floating point results may differ in rounding since lanes are summed separately.
+    template <class T>
+    internal::SumType<T> Array::sum() const noexcept {
+        static_assert(std::is_arithmetic<T>::value, "sum requires an arithmetic element type");
+        if (arr_ == end_)
+            return {};
+        assert(has_type<T>());
+        return internal::simd::sum(static_cast<const T*>(arr_), size());
+    }
+
+    template <class T>
+    T Array::min() const noexcept {
+        return minmax<T>().first;
+    }
+
+    template <class T>
+    T Array::max() const noexcept {
+        return minmax<T>().second;
+    }
+
+    /// \brief smallest and largest element of a non-empty array
+    template <class T>
+    std::pair<T, T> Array::minmax() const noexcept {
+        static_assert(std::is_arithmetic<T>::value, "minmax requires an arithmetic element type");
+        assert(has_type<T>() && !empty());
+        return internal::simd::minmax(static_cast<const T*>(arr_), size());
     }
 
-    inline bool Array::empty() const noexcept { return arr_ == nullptr; }
+    /// \brief arithmetic mean, NaN if empty
+    template <class T>
+    double Array::mean() const noexcept {
+        if (arr_ == end_)
+            return std::numeric_limits<double>::quiet_NaN();
+        return static_cast<double>(sum<T>()) / static_cast<double>(size());
+    }
+
+    /// \brief sum of products of elements of two arrays of same type and size
+    template <class T>
+    internal::SumType<T> Array::dot(const Array& other) const noexcept {
+        static_assert(std::is_arithmetic<T>::value, "dot requires an arithmetic element type");
+        if (arr_ == end_)
+            return {};
+        assert(has_type<T>() && other.has_type<T>() && size() == other.size());
+        return internal::simd::dot(static_cast<const T*>(arr_), static_cast<const T*>(other.arr_), size());
+    }
+
+    inline bool Array::empty() const noexcept { return arr_ == end_; }
 
     inline size_t Array::size() const noexcept {
-        return helper_->distance(end_, arr_);
+        return distance(end_, arr_);
+    }
+
+    template <class T>
+    void Array::bind_type() noexcept {
+        helper_ = internal::GetArrayHelper<T>();
+        elem_size_ = sizeof(T);
+    }
+
+    inline void* Array::advance(const void* ptr, size_t n) const noexcept {
+        return static_cast<char*>(const_cast<void*>(ptr)) + n * elem_size_;
+    }
+
+    inline size_t Array::distance(const void* last, const void* first) const noexcept {
+        return static_cast<size_t>(static_cast<const char*>(last) - static_cast<const char*>(first)) / elem_size_;
     }
 
+    /// \brief grow or shrink to [new_size], storage is only reallocated beyond capacity()
     inline void Array::resize(size_t new_size) {
         if (helper_ == nullptr)
             return;
-        void* old_arr = arr_;
+        unshare();
         size_t old_size = size();
-        arr_ = helper_->make_copy(arr_, new_size, std::min(old_size, new_size));
-        end_ = helper_->advance(arr_, new_size);
-        helper_->destroy_deallocate(old_arr, old_size); // destroy old content
-        if (new_size > old_size) {
-            helper_->construct(helper_->advance(arr_, old_size),
-                               new_size - old_size);
+        if (new_size <= old_size) {
+            helper_->destroy(advance(arr_, new_size), old_size - new_size);
+            end_ = advance(arr_, new_size);
+            return;
+        }
+        if (new_size > capacity()) {
+            reserve(new_size);
+        }
+        helper_->construct_default(end_, new_size - old_size);
+        end_ = advance(arr_, new_size);
+    }
+
+    inline size_t Array::capacity() const noexcept {
+        if (helper_ == nullptr) {
+            return 0;
+        }
+        return distance(cap_, arr_);
+    }
+
+    /// \brief make room for at least [new_capacity] elements without changing size()
+    inline void Array::reserve(size_t new_capacity) {
+        if (helper_ == nullptr)
+            return;
+        unshare();
+        size_t old_capacity = capacity();
+        if (new_capacity <= old_capacity)
+            return;
+        size_t n = size();
+        arr_ = helper_->reallocate(arr_, n, old_capacity, new_capacity);
+        end_ = advance(arr_, n);
+        cap_ = advance(arr_, new_capacity);
+    }
+
+    /// \brief release unused capacity
+    inline void Array::shrink_to_fit() {
+        if (helper_ == nullptr)
+            return;
+        unshare();
+        if (end_ == cap_)
+            return;
+        size_t n = size();
+        if (n == 0) {
+            helper_->destroy_deallocate(arr_, 0, capacity());
+            arr_ = end_ = cap_ = nullptr;
+            return;
         }
+        arr_ = helper_->reallocate(arr_, n, capacity(), n);
+        end_ = cap_ = advance(arr_, n);
     }
 
     /// \brief  Destroy all elements in the array and release memory.
@@ -566,54 +1963,1926 @@ namespace typeless {
         if (helper_ == nullptr) {
             return;
         }
-        helper_->destroy_deallocate(arr_, size());
+        if (block_ != nullptr) {
+            internal::release(block_);
+            block_ = nullptr;
+            return;
+        }
+        helper_->destroy_deallocate(arr_, size(), capacity());
     }
 
     inline void Array::invalidate() noexcept {
         helper_ = nullptr;
-        arr_ = end_ = nullptr;
+        elem_size_ = 1;
+        arr_ = end_ = cap_ = nullptr;
+        block_ = nullptr;
     }
 
-    inline void Array::swap(Array& right) noexcept { std::swap(*this, right); }
+    /// \brief view of [length] elements from [offset] sharing this array's buffer, no element is copied.
+    ///        The first slice moves the buffer into a shared block, which is not thread safe
+    ///        against other calls on this array; copying and destroying views is.
+    inline ArrayView Array::slice(size_t offset, size_t length) const {
+        assert(offset <= size() && length <= size() - offset);
+        if (arr_ == nullptr) {
+            return ArrayView();
+        }
+        return ArrayView(share(), helper_, elem_size_, advance(arr_, offset), advance(arr_, offset + length));
+    }
 
-    inline const type_info& Array::type() const noexcept {
-        if (helper_ == nullptr) {
-            return typeid(nullptr);
+    /// \brief add a reference to the shared block, moving the buffer into a new one first if needed
+    inline internal::ArrayBlock* Array::share() const {
+        if (block_ == nullptr) {
+            block_ = new internal::ArrayBlock{{1}, helper_, arr_, size(), capacity()};
         }
-        return *helper_->type();
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+        return block_;
     }
 
-    inline const char* Array::type_name() const noexcept {
-        if (helper_ == nullptr) {
-            return "null";
+    /// \brief in copy on write mode copies share the buffer through an atomic reference count,
+    ///        and the first change to a shared array (non-const at<T>, data<T>, set, resize, ...)
+    ///        copies its elements. Copies inherit the mode.
+    ///        Copying one array from several threads at once is safe while it is shared,
+    ///        the buffer is moved into the shared block here and again on the first copy after a change.
+    inline void Array::set_copy_on_write(bool enable) {
+        cow_ = enable;
+        if (enable && arr_ != nullptr && block_ == nullptr) {
+            block_ = new internal::ArrayBlock{{1}, helper_, arr_, size(), capacity()};
         }
-        return helper_->type()->name();
     }
 
-    inline void* Array::begin() noexcept { return arr_; }
-    inline void* Array::end() noexcept { return end_; }
-    inline const void* Array::cbegin() const noexcept { return arr_; }
-    inline const void* Array::cend() const noexcept { return end_; }
-#pragma endregion ArrayImpl
+    inline bool Array::copy_on_write() const noexcept {
+        return cow_;
+    }
 
-#pragma region StringizerImpl
+    /// \brief number of arrays and views sharing the buffer, 1 if it is not shared
+    inline size_t Array::use_count() const noexcept {
+        return block_ == nullptr ? 1 : block_->refs.load(std::memory_order_relaxed);
+    }
 
-    inline std::string stringizer::to_string(const std::string& s) { return s; }
-    inline std::string stringizer::to_string(const char* c_str) { return c_str; }
-    inline std::string stringizer::to_string(const char& ch) { return {ch}; }
-    inline std::string stringizer::to_string(const Object& obj) { return obj.to_string(); }
-    template <class T>
-    std::string stringizer::to_string(const T&) {
-#pragma message( \
-    "to_string of type T is not implemented. Returning type name by default.")
-        return typeid(T).name();
+    /// \brief take back sole ownership of the buffer before a change,
+    ///        copying the elements if views still share it
+    inline void Array::unshare() {
+        if (block_ == nullptr)
+            return;
+        if (block_->refs.load(std::memory_order_acquire) == 1) {
+            delete block_;
+            block_ = nullptr;
+            return;
+        }
+        size_t n = size();
+        void* arr = helper_->make_copy(arr_, n);
+        internal::release(block_);
+        block_ = nullptr;
+        arr_ = arr;
+        end_ = cap_ = advance(arr_, n);
     }
-#pragma endregion StringizerImpl
 
-#pragma region InternalImpl
-    namespace internal {
-        template <class T, class EqualTo>
-        struct HasOperatorEqualImpl {
+    inline void Array::swap(Array& right) noexcept { std::swap(*this, right); }
+
+    /// \brief hash of element type and elements, consistent with operator==
+    inline size_t Array::hash() const {
+        if (helper_ == nullptr) {
+            return 0;
+        }
+        return internal::hash_combine(static_cast<size_t>(helper_->type_id), helper_->hash(arr_, size()));
+    }
+
+    template <typename T>
+    bool Array::has_type() const noexcept {
+        return internal::has_type<T>(helper_);
+    }
+
+    inline internal::TypeId Array::type_id() const noexcept {
+        if (helper_ == nullptr) {
+            return internal::type_id<std::nullptr_t>();
+        }
+        return helper_->type_id;
+    }
+
+    inline const type_info& Array::type() const noexcept {
+        if (helper_ == nullptr) {
+            return typeid(nullptr);
+        }
+        return *helper_->type;
+    }
+
+    inline const char* Array::type_name() const noexcept {
+        if (helper_ == nullptr) {
+            return "null";
+        }
+        return helper_->type->name();
+    }
+
+    inline void* Array::begin() {
+        unshare();
+        return arr_;
+    }
+    inline void* Array::end() {
+        unshare();
+        return end_;
+    }
+    inline const void* Array::cbegin() const noexcept { return arr_; }
+    inline const void* Array::cend() const noexcept { return end_; }
+#pragma endregion ArrayImpl
+
+#pragma region TypedArrayImpl
+    template <class T>
+    TypedArray<T>::TypedArray() : TypedArrayBase<T>() {
+        this->array_.template set_type<T>();
+    }
+
+    template <class T>
+    TypedArray<T>::TypedArray(ArrayInit<T> init) : TypedArrayBase<T>{Array(init)} {
+    }
+
+    template <class T>
+    template <class Iterator>
+    TypedArray<T>::TypedArray(Iterator first, Iterator last) : TypedArray() {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    /// \brief take over the storage of [arr], an Array without a type becomes an empty TypedArray.
+    /// \throw std::bad_cast if [arr] holds another type
+    template <class T>
+    TypedArray<T>::TypedArray(Array arr) : TypedArrayBase<T>{std::move(arr)} {
+        if (this->array_.helper_ == nullptr) {
+            this->array_.template bind_type<T>();
+        } else if (!this->array_.template has_type<T>()) {
+            throw std::bad_cast();
+        }
+    }
+
+    template <class T>
+    const Array& TypedArray<T>::array() const noexcept {
+        return this->array_;
+    }
+
+    /// \brief move the storage out into an untyped Array, leaving this empty
+    template <class T>
+    Array TypedArray<T>::release() noexcept {
+        Array arr(std::move(this->array_));
+        this->array_.template bind_type<T>();
+        return arr;
+    }
+
+    template <class T>
+    T* TypedArray<T>::data() {
+        this->array_.unshare();
+        return static_cast<T*>(this->array_.arr_);
+    }
+
+    template <class T>
+    const T* TypedArray<T>::data() const noexcept {
+        return static_cast<const T*>(this->array_.arr_);
+    }
+
+    template <class T>
+    T& TypedArray<T>::operator[](size_t idx) {
+        assert(idx < size());
+        return data()[idx];
+    }
+
+    template <class T>
+    const T& TypedArray<T>::operator[](size_t idx) const noexcept {
+        assert(idx < size());
+        return data()[idx];
+    }
+
+    template <class T>
+    T& TypedArray<T>::front() {
+        return (*this)[0];
+    }
+
+    template <class T>
+    const T& TypedArray<T>::front() const noexcept {
+        return (*this)[0];
+    }
+
+    template <class T>
+    T& TypedArray<T>::back() {
+        return (*this)[size() - 1];
+    }
+
+    template <class T>
+    const T& TypedArray<T>::back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    template <class T>
+    void TypedArray<T>::push_back(const T& ele) {
+        this->array_.template emplace_back<T>(ele);
+    }
+
+    template <class T>
+    void TypedArray<T>::push_back(T&& ele) {
+        this->array_.template emplace_back<T>(std::move(ele));
+    }
+
+    template <class T>
+    template <class... Args>
+    T& TypedArray<T>::emplace_back(Args&&... args) {
+        return this->array_.template emplace_back<T>(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    bool TypedArray<T>::empty() const noexcept {
+        return this->array_.arr_ == this->array_.end_;
+    }
+
+    template <class T>
+    size_t TypedArray<T>::size() const noexcept {
+        return end() - begin();
+    }
+
+    template <class T>
+    void TypedArray<T>::resize(size_t new_size) {
+        this->array_.resize(new_size);
+    }
+
+    template <class T>
+    size_t TypedArray<T>::capacity() const noexcept {
+        return static_cast<const T*>(this->array_.cap_) - begin();
+    }
+
+    template <class T>
+    void TypedArray<T>::reserve(size_t new_capacity) {
+        this->array_.reserve(new_capacity);
+    }
+
+    template <class T>
+    void TypedArray<T>::shrink_to_fit() {
+        this->array_.shrink_to_fit();
+    }
+
+    template <class T>
+    void TypedArray<T>::swap(TypedArray& right) noexcept {
+        this->array_.swap(right.array_);
+    }
+
+    template <class T>
+    T* TypedArray<T>::begin() {
+        return data();
+    }
+
+    template <class T>
+    T* TypedArray<T>::end() {
+        this->array_.unshare();
+        return static_cast<T*>(this->array_.end_);
+    }
+
+    template <class T>
+    const T* TypedArray<T>::begin() const noexcept {
+        return data();
+    }
+
+    template <class T>
+    const T* TypedArray<T>::end() const noexcept {
+        return static_cast<const T*>(this->array_.end_);
+    }
+
+    template <class T>
+    const T* TypedArray<T>::cbegin() const noexcept {
+        return begin();
+    }
+
+    template <class T>
+    const T* TypedArray<T>::cend() const noexcept {
+        return end();
+    }
+
+    template <class T>
+    bool operator==(const TypedArray<T>& l, const TypedArray<T>& r) {
+        return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin());
+    }
+
+    template <class T>
+    bool operator!=(const TypedArray<T>& l, const TypedArray<T>& r) {
+        return !(l == r);
+    }
+
+    template <class T>
+    ArraySpan<T>::ArraySpan() noexcept : ArraySpanBase<T>{nullptr, 0} {
+    }
+
+    template <class T>
+    ArraySpan<T>::ArraySpan(T* data, size_t size) noexcept : ArraySpanBase<T>{data, size} {
+    }
+
+    /// \throw std::bad_cast if [arr] holds another type
+    template <class T>
+    ArraySpan<T>::ArraySpan(Array& arr) : ArraySpanBase<T>{checked_data(arr), 0} {
+        if (!std::is_const<T>::value) {
+            arr.unshare(); // the span may write, views of [arr] keep their elements
+            this->data_ = static_cast<T*>(arr.arr_);
+        }
+        this->size_ = static_cast<T*>(arr.end_) - this->data_;
+    }
+
+    template <class T>
+    template <class, class>
+    ArraySpan<T>::ArraySpan(const Array& arr) : ArraySpanBase<T>{checked_data(arr), 0} {
+        this->size_ = static_cast<T*>(arr.end_) - this->data_;
+    }
+
+    template <class T>
+    ArraySpan<T>::ArraySpan(TypedArray<value_type>& arr) noexcept : ArraySpanBase<T>{arr.data(), arr.size()} {
+    }
+
+    template <class T>
+    template <class, class>
+    ArraySpan<T>::ArraySpan(const TypedArray<value_type>& arr) noexcept : ArraySpanBase<T>{arr.data(), arr.size()} {
+    }
+
+    template <class T>
+    template <class U, class>
+    ArraySpan<T>::ArraySpan(const ArraySpan<U>& span) noexcept : ArraySpanBase<T>{span.data(), span.size()} {
+    }
+
+    /// \brief element pointer of [arr], null for an Array without a type
+    template <class T>
+    T* ArraySpan<T>::checked_data(const Array& arr) {
+        if (arr.helper_ != nullptr && !arr.template has_type<value_type>()) {
+            throw std::bad_cast();
+        }
+        return static_cast<T*>(arr.arr_);
+    }
+
+    template <class T>
+    T* ArraySpan<T>::data() const noexcept {
+        return this->data_;
+    }
+
+    template <class T>
+    T& ArraySpan<T>::operator[](size_t idx) const noexcept {
+        assert(idx < this->size_);
+        return this->data_[idx];
+    }
+
+    template <class T>
+    T& ArraySpan<T>::front() const noexcept {
+        return (*this)[0];
+    }
+
+    template <class T>
+    T& ArraySpan<T>::back() const noexcept {
+        return (*this)[this->size_ - 1];
+    }
+
+    template <class T>
+    bool ArraySpan<T>::empty() const noexcept {
+        return this->size_ == 0;
+    }
+
+    template <class T>
+    size_t ArraySpan<T>::size() const noexcept {
+        return this->size_;
+    }
+
+    template <class T>
+    ArraySpan<T> ArraySpan<T>::first(size_t count) const noexcept {
+        assert(count <= this->size_);
+        return ArraySpan(this->data_, count);
+    }
+
+    template <class T>
+    ArraySpan<T> ArraySpan<T>::last(size_t count) const noexcept {
+        assert(count <= this->size_);
+        return ArraySpan(this->data_ + (this->size_ - count), count);
+    }
+
+    template <class T>
+    ArraySpan<T> ArraySpan<T>::subspan(size_t offset, size_t count) const noexcept {
+        assert(offset <= this->size_ && count <= this->size_ - offset);
+        return ArraySpan(this->data_ + offset, count);
+    }
+
+    template <class T>
+    ArraySpan<T> ArraySpan<T>::subspan(size_t offset) const noexcept {
+        assert(offset <= this->size_);
+        return ArraySpan(this->data_ + offset, this->size_ - offset);
+    }
+
+    template <class T>
+    T* ArraySpan<T>::begin() const noexcept {
+        return this->data_;
+    }
+
+    template <class T>
+    T* ArraySpan<T>::end() const noexcept {
+        return this->data_ + this->size_;
+    }
+#pragma endregion TypedArrayImpl
+
+#pragma region ArrayViewImpl
+    inline ArrayView::ArrayView() noexcept : ArrayViewBase{nullptr, nullptr, 1, nullptr, nullptr} {
+    }
+
+    inline ArrayView::ArrayView(internal::ArrayBlock* block, const internal::ArrayHelper* helper, size_t elem_size,
+                                const void* first, const void* last) noexcept
+        : ArrayViewBase{block, helper, elem_size, first, last} {
+    }
+
+    inline ArrayView::ArrayView(const ArrayView& rhs) noexcept : ArrayViewBase(rhs) {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline ArrayView::ArrayView(ArrayView&& rhs) noexcept : ArrayViewBase(rhs) {
+        rhs.block_ = nullptr;
+        rhs.first_ = rhs.last_ = nullptr;
+    }
+
+    inline ArrayView& ArrayView::operator=(const ArrayView& rhs) noexcept {
+        ArrayView(rhs).swap(*this);
+        return *this;
+    }
+
+    inline ArrayView& ArrayView::operator=(ArrayView&& rhs) noexcept {
+        ArrayView(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    inline ArrayView::~ArrayView() noexcept {
+        if (block_ != nullptr) {
+            internal::release(block_);
+        }
+    }
+
+    /// \brief copy the viewed elements into a new Array
+    inline Array ArrayView::to_array() const {
+        Array arr;
+        if (helper_ == nullptr) {
+            return arr;
+        }
+        size_t n = size();
+        arr.helper_ = helper_;
+        arr.elem_size_ = elem_size_;
+        arr.arr_ = helper_->make_copy(first_, n);
+        arr.end_ = arr.cap_ = arr.advance(arr.arr_, n);
+        return arr;
+    }
+
+    template <class T>
+    ArraySpan<const T> ArrayView::span() const {
+        assert(empty() || has_type<T>());
+        return ArraySpan<const T>(data<T>(), size());
+    }
+
+    template <class T>
+    const T* ArrayView::data() const noexcept {
+        return static_cast<const T*>(first_);
+    }
+
+    template <class T>
+    const T& ArrayView::at(size_t idx) const noexcept {
+        assert(has_type<T>() && idx < size());
+        return data<T>()[idx];
+    }
+
+    template <class T, class Callback>
+    void ArrayView::for_each(Callback cb) const {
+        const T* last = static_cast<const T*>(last_);
+        for (const T* ptr = data<T>(); ptr != last; ++ptr) {
+            cb(*ptr);
+        }
+    }
+
+    /// \brief copy of elements satisfying [filter_fn] into a new Array, like Array::filter
+    template <class T, class Fn>
+    Array ArrayView::filter(Fn filter_fn) const {
+        Array filtered;
+        if (helper_ == nullptr)
+            return filtered;
+        assert(has_type<T>());
+        const T* first = data<T>();
+        size_t n = size();
+        std::unique_ptr<bool[]> keep(new bool[n]);
+        size_t kept = internal::mark_if(first, n, keep.get(), filter_fn);
+        filtered.helper_ = helper_;
+        filtered.elem_size_ = elem_size_;
+        filtered.reserve(kept);
+        filtered.end_ = internal::copy_marked(first, n, keep.get(), static_cast<T*>(filtered.arr_));
+        return filtered;
+    }
+
+    template <class T, class TResult>
+    TResult ArrayView::join(void (*cb)(const T&, TResult&)) const {
+        return join<T, TResult, void (*)(const T&, TResult&)>(std::move(cb));
+    }
+
+    template <class T, class TResult, class F>
+    TResult ArrayView::join(F&& cb) const {
+        TResult result{};
+        for_each<T>([&](const T& value) { cb(value, result); });
+        return result;
+    }
+
+    template <class T, class TResult, class BinaryOp>
+    TResult ArrayView::reduce(TResult init, BinaryOp&& op) const {
+        for_each<T>([&](const T& value) { init = op(std::move(init), value); });
+        return init;
+    }
+
+    /// \brief sub-range sharing the same buffer
+    inline ArrayView ArrayView::slice(size_t offset, size_t length) const {
+        assert(offset <= size() && length <= size() - offset);
+        ArrayView view(*this);
+        view.first_ = static_cast<const char*>(first_) + offset * elem_size_;
+        view.last_ = static_cast<const char*>(view.first_) + length * elem_size_;
+        return view;
+    }
+
+    inline bool ArrayView::empty() const noexcept {
+        return first_ == last_;
+    }
+
+    inline size_t ArrayView::size() const noexcept {
+        return static_cast<size_t>(static_cast<const char*>(last_) - static_cast<const char*>(first_)) / elem_size_;
+    }
+
+    /// \brief number of views and arrays sharing the buffer, 0 for an empty view
+    inline size_t ArrayView::use_count() const noexcept {
+        return block_ == nullptr ? 0 : block_->refs.load(std::memory_order_relaxed);
+    }
+
+    inline void ArrayView::swap(ArrayView& right) noexcept {
+        std::swap(static_cast<ArrayViewBase&>(*this), static_cast<ArrayViewBase&>(right));
+    }
+
+    template <typename T>
+    bool ArrayView::has_type() const noexcept {
+        return internal::has_type<T>(helper_);
+    }
+
+    inline internal::TypeId ArrayView::type_id() const noexcept {
+        if (helper_ == nullptr) {
+            return internal::type_id<std::nullptr_t>();
+        }
+        return helper_->type_id;
+    }
+
+    inline const type_info& ArrayView::type() const noexcept {
+        if (helper_ == nullptr) {
+            return typeid(nullptr);
+        }
+        return *helper_->type;
+    }
+
+    inline const char* ArrayView::type_name() const noexcept {
+        return type().name();
+    }
+
+    inline const void* ArrayView::cbegin() const noexcept {
+        return first_;
+    }
+
+    inline const void* ArrayView::cend() const noexcept {
+        return last_;
+    }
+#pragma endregion ArrayViewImpl
+
+#pragma region VariantArrayImpl
+    inline VariantRef::VariantRef(const internal::ObjectHelper* helper, const void* value) noexcept
+        : VariantRefBase{helper, value} {
+    }
+
+    template <class T>
+    const T& VariantRef::get() const noexcept {
+        assert(has_type<T>());
+        return *static_cast<const T*>(value_);
+    }
+
+    inline const void* VariantRef::data() const noexcept {
+        return value_;
+    }
+
+    /// \brief copy of the value as an Object
+    inline Object VariantRef::object() const {
+        Object obj;
+        obj.value_ = helper_->make_copy(&obj.storage_, value_);
+        obj.helper_ = helper_;
+        return obj;
+    }
+
+    inline std::string VariantRef::to_string() const {
+        std::string out;
+        append_to(out);
+        return out;
+    }
+
+    inline void VariantRef::append_to(std::string& out) const {
+        helper_->append_to(out, value_);
+    }
+
+    template <typename T>
+    bool VariantRef::has_type() const noexcept {
+        return internal::has_type<T>(helper_);
+    }
+
+    inline internal::TypeId VariantRef::type_id() const noexcept {
+        return helper_->type_id;
+    }
+
+    inline const type_info& VariantRef::type() const noexcept {
+        return *helper_->type;
+    }
+
+    inline const char* VariantRef::type_name() const noexcept {
+        return helper_->type->name();
+    }
+
+    inline VariantArray::VariantArray() noexcept : VariantArrayBase{{}, {}, {}, {}, 0, 0} {
+    }
+
+    inline VariantArray::VariantArray(ObjectArray init) : VariantArray() {
+        reserve(init.size());
+        for (const Object& obj : init) {
+            push_back(obj);
+        }
+    }
+
+    /// \brief pack an Array of Object
+    inline VariantArray::VariantArray(const Array& objects) : VariantArray() {
+        assert(objects.empty() || objects.has_type<Object>());
+        reserve(objects.size());
+        objects.for_each<Object>([this](const Object& obj) { push_back(obj); });
+    }
+
+    /// \brief tags and inline values are copied in bulk, only arena values are copied one by one
+    inline VariantArray::VariantArray(const VariantArray& rhs)
+        : VariantArrayBase{rhs.tags_, rhs.slots_, rhs.types_, {}, 0, 0} {
+        size_t i = 0;
+        try {
+            for (; i < size(); ++i) {
+                const internal::ObjectHelper* helper = types_[tags_[i]];
+                if (internal::is_variant_inline(helper))
+                    continue;
+                void* dst = arena_allocate(helper->size, helper->align);
+                helper->copy_construct(dst, rhs.value(i));
+                ::new (&slots_[i]) void*(dst);
+            }
+        } catch (...) {
+            tags_.resize(i); // destroy only the values copied so far
+            clear();
+            throw;
+        }
+    }
+
+    inline VariantArray::VariantArray(VariantArray&& rhs) noexcept : VariantArray() {
+        swap(rhs);
+    }
+
+    inline VariantArray& VariantArray::operator=(const VariantArray& rhs) {
+        VariantArray(rhs).swap(*this);
+        return *this;
+    }
+
+    inline VariantArray& VariantArray::operator=(VariantArray&& rhs) noexcept {
+        VariantArray(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    inline VariantArray::~VariantArray() noexcept {
+        clear();
+    }
+
+    /// \brief unpack into an Array of Object
+    inline Array VariantArray::to_array() const {
+        Array objects;
+        objects.set_type<Object>();
+        objects.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            objects.emplace_back<Object>(at(i));
+        }
+        return objects;
+    }
+
+    inline VariantRef VariantArray::operator[](size_t idx) const noexcept {
+        assert(idx < size());
+        return VariantRef(types_[tags_[idx]], value(idx));
+    }
+
+    template <class T>
+    const T& VariantArray::get(size_t idx) const noexcept {
+        assert(has_type<T>(idx));
+        return *static_cast<const T*>(value(idx));
+    }
+
+    inline Object VariantArray::at(size_t idx) const {
+        return (*this)[idx].object();
+    }
+
+    template <class T, class>
+    void VariantArray::push_back(T&& value) {
+        using U = std::decay_t<T>;
+        static_assert(alignof(U) <= alignof(std::max_align_t), "over-aligned types can not be packed in a VariantArray");
+        emplace(internal::GetObjectHelper<U>(), [&value](void* dst) { ::new (dst) U(std::forward<T>(value)); });
+    }
+
+    /// \throw std::invalid_argument if [obj] is empty or holds an over-aligned type
+    inline void VariantArray::push_back(const Object& obj) {
+        if (obj.empty()) {
+            throw std::invalid_argument("empty Object can not be packed in a VariantArray");
+        }
+        const internal::ObjectHelper* helper = obj.helper_;
+        if (helper->align > alignof(std::max_align_t)) {
+            throw std::invalid_argument(string("over-aligned type ") + obj.type_name() +
+                                        " can not be packed in a VariantArray");
+        }
+        const void* src = obj.value_;
+        emplace(helper, [helper, src](void* dst) { helper->copy_construct(dst, src); });
+    }
+
+    /// \brief call [f] with a VariantRef to each element
+    template <class F>
+    void VariantArray::visit(F f) const {
+        for (size_t i = 0; i < size(); ++i) {
+            f((*this)[i]);
+        }
+    }
+
+    /// \brief call [f] with each element of type T, the type is resolved once and the scan only compares tags
+    template <class T, class F>
+    void VariantArray::for_each(F f) const {
+        int tag = find_tag<T>();
+        if (tag < 0)
+            return;
+        const unsigned char* tags = tags_.data();
+        const internal::VariantSlot* slots = slots_.data();
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            if (tags[i] != tag)
+                continue;
+            const void* slot = &slots[i];
+            f(*static_cast<const T*>(internal::IsVariantInline<T>::value ? slot : *static_cast<void* const*>(slot)));
+        }
+    }
+
+    template <class T>
+    size_t VariantArray::count() const noexcept {
+        int tag = find_tag<T>();
+        return tag < 0 ? 0 : std::count(tags_.begin(), tags_.end(), static_cast<unsigned char>(tag));
+    }
+
+    inline bool VariantArray::empty() const noexcept {
+        return tags_.empty();
+    }
+
+    inline size_t VariantArray::size() const noexcept {
+        return tags_.size();
+    }
+
+    inline void VariantArray::reserve(size_t n) {
+        tags_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    inline void VariantArray::clear() noexcept {
+        for (size_t i = 0; i < size(); ++i) {
+            const internal::ObjectHelper* helper = types_[tags_[i]];
+            if (!helper->trivially_copyable) {
+                helper->destruct(const_cast<void*>(value(i)));
+            }
+        }
+        tags_.clear();
+        slots_.clear();
+        types_.clear();
+        chunks_.clear();
+        chunk_used_ = chunk_size_ = 0;
+    }
+
+    inline void VariantArray::swap(VariantArray& right) noexcept {
+        tags_.swap(right.tags_);
+        slots_.swap(right.slots_);
+        types_.swap(right.types_);
+        chunks_.swap(right.chunks_);
+        std::swap(chunk_used_, right.chunk_used_);
+        std::swap(chunk_size_, right.chunk_size_);
+    }
+
+    template <typename T>
+    bool VariantArray::has_type(size_t idx) const noexcept {
+        assert(idx < size());
+        return internal::has_type<T>(types_[tags_[idx]]);
+    }
+
+    inline const type_info& VariantArray::type(size_t idx) const noexcept {
+        assert(idx < size());
+        return *types_[tags_[idx]]->type;
+    }
+
+    /// \brief tag of T, -1 if no element has type T
+    template <class T>
+    int VariantArray::find_tag() const noexcept {
+        for (size_t tag = 0; tag < types_.size(); ++tag) {
+            if (internal::has_type<T>(types_[tag])) {
+                return static_cast<int>(tag);
+            }
+        }
+        return -1;
+    }
+
+    /// \brief tag of [helper]'s type, added to the type table if new
+    inline unsigned char VariantArray::tag_of(const internal::ObjectHelper* helper) {
+        for (size_t tag = 0; tag < types_.size(); ++tag) {
+            if (internal::same_type(types_[tag], helper)) {
+                return static_cast<unsigned char>(tag);
+            }
+        }
+        if (types_.size() > std::numeric_limits<unsigned char>::max()) {
+            throw std::length_error("VariantArray holds at most 256 distinct types");
+        }
+        types_.push_back(helper);
+        return static_cast<unsigned char>(types_.size() - 1);
+    }
+
+    inline const void* VariantArray::value(size_t idx) const noexcept {
+        const void* slot = &slots_[idx];
+        return internal::is_variant_inline(types_[tags_[idx]]) ? slot : *static_cast<void* const*>(slot);
+    }
+
+    /// \brief bump allocate [size] bytes from the arena, values larger than a chunk get a chunk of their own.
+    ///        Chunks are only aligned for std::max_align_t, push_back rejects stricter alignments
+    inline void* VariantArray::arena_allocate(size_t size, size_t align) {
+        assert(align <= alignof(std::max_align_t));
+        size_t offset = (chunk_used_ + align - 1) & ~(align - 1);
+        if (chunks_.empty() || offset + size > chunk_size_) {
+            size_t chunk_size = std::max(size, internal::VARIANT_CHUNK_SIZE);
+            chunks_.emplace_back(new char[chunk_size]);
+            chunk_size_ = chunk_size;
+            offset = 0;
+        }
+        chunk_used_ = offset + size;
+        return chunks_.back().get() + offset;
+    }
+
+    /// \brief append an element of [helper]'s type, [construct] builds the value at the address it is given
+    template <class Construct>
+    void VariantArray::emplace(const internal::ObjectHelper* helper, Construct construct) {
+        tags_.push_back(tag_of(helper));
+        try {
+            slots_.emplace_back();
+            void* slot = &slots_.back();
+            try {
+                if (internal::is_variant_inline(helper)) {
+                    construct(slot);
+                } else {
+                    void* dst = arena_allocate(helper->size, helper->align);
+                    construct(dst);
+                    ::new (slot) void*(dst);
+                }
+            } catch (...) {
+                slots_.pop_back();
+                throw;
+            }
+        } catch (...) {
+            tags_.pop_back();
+            throw;
+        }
+    }
+#pragma endregion VariantArrayImpl
+
+#pragma region TableImpl
+    inline TableRow::TableRow(const Table* table, size_t index) noexcept : TableRowBase{table, index} {
+    }
+
+    inline VariantRef TableRow::operator[](size_t column) const {
+        return table_->cell(index_, column);
+    }
+
+    inline VariantRef TableRow::operator[](const string& name) const {
+        return table_->cell(index_, table_->column_index(name));
+    }
+
+    template <class T>
+    const T& TableRow::get(const string& name) const {
+        return (*this)[name].get<T>();
+    }
+
+    inline size_t TableRow::index() const noexcept {
+        return index_;
+    }
+
+    inline size_t TableRow::size() const noexcept {
+        return table_->columns();
+    }
+
+    /// \brief materialize the row as an Array of Object, one per column
+    inline Array TableRow::to_array() const {
+        Array objects;
+        objects.set_type<Object>();
+        objects.reserve(size());
+        for (size_t column = 0; column < size(); ++column) {
+            objects.emplace_back<Object>((*this)[column].object());
+        }
+        return objects;
+    }
+
+    inline Table::Table() noexcept : TableBase{{}, {}, {}, 0} {
+    }
+
+    /// \brief add a column of value initialized T for the existing rows
+    template <class T>
+    void Table::add_column(const string& name) {
+        Array column;
+        column.set_type<T>();
+        column.resize(rows_);
+        add_column<T>(name, std::move(column));
+    }
+
+    /// \brief add [column] as is, the first column sets the number of rows.
+    /// \throw std::invalid_argument if [name] is taken or the length differs from rows(),
+    ///        std::bad_cast if [column] holds another type
+    template <class T>
+    void Table::add_column(const string& name, Array column) {
+        if (has_column(name)) {
+            throw std::invalid_argument("duplicate column " + name);
+        }
+        if (column.helper_ == nullptr) {
+            column.bind_type<T>();
+        } else if (!column.has_type<T>()) {
+            throw std::bad_cast();
+        }
+        if (!columns_.empty() && column.size() != rows_) {
+            throw std::invalid_argument("column " + name + " has " + std::to_string(column.size()) +
+                                        " rows, expected " + std::to_string(rows_));
+        }
+        names_.reserve(names_.size() + 1);
+        columns_.reserve(columns_.size() + 1);
+        types_.reserve(types_.size() + 1);
+        rows_ = column.size();
+        names_.push_back(name);
+        columns_.push_back(std::move(column));
+        types_.push_back(internal::GetObjectHelper<T>());
+    }
+
+    inline const Array& Table::column(size_t idx) const noexcept {
+        assert(idx < columns());
+        return columns_[idx];
+    }
+
+    inline const Array& Table::column(const string& name) const {
+        return columns_[column_index(name)];
+    }
+
+    /// \brief mutable view of a column, elements can be changed but not added or removed
+    template <class T>
+    ArraySpan<T> Table::span(const string& name) {
+        return ArraySpan<T>(columns_[column_index(name)]);
+    }
+
+    template <class T>
+    ArraySpan<const T> Table::span(const string& name) const {
+        return ArraySpan<const T>(columns_[column_index(name)]);
+    }
+
+    inline const string& Table::column_name(size_t idx) const noexcept {
+        assert(idx < columns());
+        return names_[idx];
+    }
+
+    /// \throw std::out_of_range if there is no column [name]
+    inline size_t Table::column_index(const string& name) const {
+        auto it = std::find(names_.begin(), names_.end(), name);
+        if (it == names_.end()) {
+            throw std::out_of_range("no column " + name);
+        }
+        return it - names_.begin();
+    }
+
+    inline bool Table::has_column(const string& name) const noexcept {
+        return std::find(names_.begin(), names_.end(), name) != names_.end();
+    }
+
+    inline size_t Table::columns() const noexcept {
+        return columns_.size();
+    }
+
+    /// \brief append one value per column, the table is unchanged if this throws.
+    /// \throw std::invalid_argument if the number of values differs from columns(),
+    ///        std::bad_cast if a value does not have the type of its column
+    inline void Table::append_row(ObjectArray values) {
+        if (values.size() != columns()) {
+            throw std::invalid_argument("row has " + std::to_string(values.size()) + " values, expected " +
+                                        std::to_string(columns()));
+        }
+        const Object* value = values.begin();
+        for (size_t c = 0; c < columns(); ++c) {
+            if (!internal::same_type(value[c].helper_, columns_[c].helper_)) {
+                throw std::bad_cast();
+            }
+        }
+        for (Array& column : columns_) {
+            column.unshare();
+            if (column.end_ == column.cap_) {
+                column.reserve(std::max<size_t>(column.capacity() * 2, 4));
+            }
+        }
+        try {
+            for (size_t c = 0; c < columns(); ++c) {
+                Array& column = columns_[c];
+                column.helper_->construct(column.end_, value[c].data());
+                column.end_ = column.advance(column.end_, 1);
+            }
+        } catch (...) {
+            for (Array& column : columns_) {
+                column.resize(rows_);
+            }
+            throw;
+        }
+        ++rows_;
+    }
+
+    inline TableRow Table::row(size_t idx) const noexcept {
+        assert(idx < rows_);
+        return TableRow(this, idx);
+    }
+
+    inline VariantRef Table::cell(size_t row, size_t column) const noexcept {
+        assert(row < rows_ && column < columns());
+        const Array& col = columns_[column];
+        return VariantRef(types_[column], col.advance(col.arr_, row));
+    }
+
+    inline size_t Table::rows() const noexcept {
+        return rows_;
+    }
+
+    inline bool Table::empty() const noexcept {
+        return rows_ == 0;
+    }
+
+    inline void Table::reserve(size_t rows) {
+        for (Array& column : columns_) {
+            column.reserve(rows);
+        }
+    }
+
+    /// \brief remove all rows, columns keep their type.
+    ///        A column buffer shared with views or copies is released rather than copied,
+    ///        otherwise its capacity is kept for new rows
+    inline void Table::clear() noexcept {
+        for (Array& column : columns_) {
+            if (column.block_ != nullptr) {
+                column.destroy();
+                column.arr_ = column.end_ = column.cap_ = nullptr;
+            } else {
+                column.resize(0); // does not allocate without a shared block
+            }
+        }
+        rows_ = 0;
+    }
+#pragma endregion TableImpl
+
+#pragma region SharedObjectImpl
+    namespace internal {
+        struct SharedBlock {
+            std::atomic<size_t> refs;
+            Object value;
+        };
+    } // namespace internal
+
+    inline SharedObject::SharedObject() noexcept : SharedObjectBase{nullptr} {
+    }
+
+    inline SharedObject::~SharedObject() noexcept {
+        reset();
+    }
+
+    template <class T, class>
+    SharedObject::SharedObject(T&& value)
+        : SharedObjectBase{new internal::SharedBlock{{1}, Object(std::forward<T>(value))}} {
+    }
+
+    inline SharedObject::SharedObject(Object obj) : SharedObjectBase{nullptr} {
+        if (!obj.empty()) {
+            block_ = new internal::SharedBlock{{1}, std::move(obj)};
+        }
+    }
+
+    inline SharedObject::SharedObject(const SharedObject& rhs) noexcept : SharedObjectBase{rhs.block_} {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline SharedObject::SharedObject(SharedObject&& rhs) noexcept : SharedObjectBase{rhs.block_} {
+        rhs.block_ = nullptr;
+    }
+
+    inline SharedObject& SharedObject::operator=(const SharedObject& rhs) noexcept {
+        SharedObject(rhs).swap(*this);
+        return *this;
+    }
+
+    inline SharedObject& SharedObject::operator=(SharedObject&& rhs) noexcept {
+        SharedObject(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /// \brief mutable access to the value, copying it first if it is shared.
+    ///        Like Object::get, it must not be called on an empty object
+    template <class T>
+    T& SharedObject::get() {
+        assert(!empty());
+        detach();
+        return *static_cast<T*>(object().data());
+    }
+
+    template <class T>
+    const T& SharedObject::get() const {
+        assert(!empty());
+        return *static_cast<const T*>(object().data());
+    }
+
+    inline const Object& SharedObject::object() const noexcept {
+        static const Object null;
+        return block_ == nullptr ? null : block_->value;
+    }
+
+    /// \brief make the value private to this object
+    inline void SharedObject::detach() {
+        if (block_ == nullptr || unique()) {
+            return;
+        }
+        SharedObject(block_->value.clone()).swap(*this);
+    }
+
+    inline bool SharedObject::unique() const noexcept {
+        return use_count() == 1;
+    }
+
+    inline size_t SharedObject::use_count() const noexcept {
+        return block_ == nullptr ? 0 : block_->refs.load(std::memory_order_acquire);
+    }
+
+    inline bool SharedObject::empty() const noexcept { return block_ == nullptr; }
+
+    /// \brief release the value, destroying it if this was the last reference
+    inline void SharedObject::reset() noexcept {
+        if (block_ != nullptr && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block_;
+        }
+        block_ = nullptr;
+    }
+
+    inline void SharedObject::swap(SharedObject& right) noexcept { std::swap(block_, right.block_); }
+
+    inline std::string SharedObject::to_string() const { return object().to_string(); }
+
+    template <typename T>
+    bool SharedObject::has_type() const noexcept {
+        return object().has_type<T>();
+    }
+
+    inline internal::TypeId SharedObject::type_id() const noexcept { return object().type_id(); }
+
+    inline const type_info& SharedObject::type() const noexcept { return object().type(); }
+
+    inline const char* SharedObject::type_name() const noexcept { return object().type_name(); }
+#pragma endregion SharedObjectImpl
+
+#pragma region ThreadPoolImpl
+    namespace internal {
+        inline ChunkLayout::ChunkLayout(const void* data, size_t n, size_t element_size, size_t chunk_bytes) noexcept
+            : n_(n), head_(0), step_(std::max<size_t>(1, chunk_bytes / element_size)) {
+            if (CACHE_LINE_SIZE % element_size == 0) {
+                size_t per_line = CACHE_LINE_SIZE / element_size;
+                step_ = (step_ + per_line - 1) / per_line * per_line;
+                size_t misalignment = reinterpret_cast<std::uintptr_t>(data) % CACHE_LINE_SIZE;
+                if (misalignment % element_size == 0) {
+                    head_ = (CACHE_LINE_SIZE - misalignment) % CACHE_LINE_SIZE / element_size;
+                }
+            }
+            count_ = n_ == 0 ? 0 : n_ <= head_ + step_ ? 1 : 1 + (n_ - head_ - 1) / step_;
+        }
+
+        /// \brief state of one parallel_for call, lives on the stack of the calling thread
+        template <class F>
+        struct PoolJob {
+            F& fn;
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed;
+            std::exception_ptr error;
+
+            static void run(void* self, size_t index) {
+                PoolJob* job = static_cast<PoolJob*>(self);
+                if (!job->failed.load(std::memory_order_relaxed)) { // skip remaining tasks after an error
+                    try {
+                        job->fn(index);
+                    } catch (...) {
+                        if (!job->failed.exchange(true)) {
+                            job->error = std::current_exception();
+                        }
+                    }
+                }
+                job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        };
+
+        /// \brief pool and queue index of the calling thread if it is a pool worker
+        struct WorkerIdentity {
+            const ThreadPool* pool;
+            size_t queue_index;
+        };
+
+        inline WorkerIdentity& this_worker() noexcept {
+            static thread_local WorkerIdentity identity{nullptr, 0};
+            return identity;
+        }
+    } // namespace internal
+
+    inline ThreadPool::ThreadPool(size_t n_threads) : ThreadPoolBase() {
+        n_threads = std::max<size_t>(n_threads, 1);
+        pending_ = 0;
+        stop_ = false;
+        chunk_size_ = 64 * 1024;
+        for (size_t i = 0; i < n_threads; ++i) {
+            queues_.emplace_back(new internal::WorkQueue());
+        }
+        for (size_t i = 1; i < n_threads; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_main, this, i);
+        }
+    }
+
+    inline ThreadPool::~ThreadPool() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /// \brief number of threads running tasks, including the caller
+    inline size_t ThreadPool::size() const noexcept { return queues_.size(); }
+
+    /// \brief bytes of Array data handled by one task
+    inline size_t ThreadPool::chunk_size() const noexcept { return chunk_size_; }
+
+    inline void ThreadPool::set_chunk_size(size_t n_bytes) noexcept {
+        chunk_size_ = std::max<size_t>(n_bytes, internal::CACHE_LINE_SIZE);
+    }
+
+    /// \brief call fn(i) for every i in [0, n) on the pool and wait for all of them.
+    ///        The first exception thrown by [fn] is rethrown here after every task finished.
+    template <class F>
+    void ThreadPool::parallel_for(size_t n, F&& fn) {
+        if (n == 1 || queues_.size() == 1) {
+            for (size_t i = 0; i < n; ++i) {
+                fn(i);
+            }
+            return;
+        }
+        internal::PoolJob<F> job{fn, {n}, {false}, nullptr};
+        std::vector<internal::PoolTask> tasks(n);
+        for (size_t i = 0; i < n; ++i) {
+            tasks[i] = {&internal::PoolJob<F>::run, &job, i};
+        }
+        push(tasks.data(), n);
+        size_t queue_index = current_queue();
+        while (job.remaining.load(std::memory_order_acquire) != 0) {
+            if (!run_one(queue_index)) {
+                std::this_thread::yield();
+            }
+        }
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    /// \brief call fn(begin, end) on cache aligned chunks of [data, data + n)
+    template <class T, class F>
+    void ThreadPool::parallel_chunks(T* data, size_t n, F&& fn) {
+        internal::ChunkLayout layout(data, n, sizeof(T), chunk_size_);
+        parallel_for(layout.count(), [&](size_t chunk) {
+            fn(data + layout.begin(chunk), data + layout.end(chunk));
+        });
+    }
+
+    /// \brief spread [tasks] over all queues in contiguous blocks, so neighbouring chunks stay on one thread
+    inline void ThreadPool::push(const internal::PoolTask* tasks, size_t n) {
+        pending_.fetch_add(n);
+        size_t n_queues = queues_.size();
+        for (size_t q = 0; q < n_queues; ++q) {
+            size_t first = n * q / n_queues, last = n * (q + 1) / n_queues;
+            std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+            queues_[q]->tasks.insert(queues_[q]->tasks.end(), tasks + first, tasks + last);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_all();
+    }
+
+    /// \brief run a task from own queue, or steal one from another queue
+    inline bool ThreadPool::run_one(size_t queue_index) {
+        internal::PoolTask task;
+        bool found = false;
+        {
+            internal::WorkQueue& own = *queues_[queue_index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                found = true;
+            }
+        }
+        for (size_t i = 1; !found && i < queues_.size(); ++i) {
+            internal::WorkQueue& victim = *queues_[(queue_index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        pending_.fetch_sub(1);
+        task.run(task.job, task.index);
+        return true;
+    }
+
+    inline void ThreadPool::worker_main(size_t queue_index) {
+        internal::this_worker() = {this, queue_index};
+        for (;;) {
+            if (run_one(queue_index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stop_ || pending_.load() != 0; });
+            if (stop_) {
+                return;
+            }
+        }
+    }
+
+    inline size_t ThreadPool::current_queue() const noexcept {
+        const internal::WorkerIdentity& identity = internal::this_worker();
+        return identity.pool == this ? identity.queue_index : 0;
+    }
+#pragma endregion ThreadPoolImpl
+
+#pragma region StringizerImpl
+
+    inline void stringizer::append_to(std::string& out, const std::string& s) { out += s; }
+    inline void stringizer::append_to(std::string& out, const char* c_str) { out += c_str; }
+    inline void stringizer::append_to(std::string& out, const char& ch) { out += ch; }
+    inline void stringizer::append_to(std::string& out, const bool& b) { out += b ? '1' : '0'; }
+    inline void stringizer::append_to(std::string& out, const Object& obj) { obj.append_to(out); }
+
+    /// \brief shortest representation that reads back to the same value
+    template <class T, std::enable_if_t<std::is_arithmetic<T>::value, int>>
+    void stringizer::append_to(std::string& out, const T& value) {
+        char buf[64];
+        out.append(buf, internal::format_number(buf, buf + sizeof(buf), value));
+    }
+
+    template <class T, std::enable_if_t<!std::is_arithmetic<T>::value, int>>
+    void stringizer::append_to(std::string& out, const T&) {
+#pragma message( \
+    "to_string of type T is not implemented. Returning type name by default.")
+        out += typeid(T).name();
+    }
+
+    template <class T>
+    std::string stringizer::to_string(const T& value) {
+        std::string out;
+        append_to(out, value);
+        return out;
+    }
+#pragma endregion StringizerImpl
+
+#pragma region SimdImpl
+    namespace internal {
+        namespace simd {
+            /// \brief accumulator of sum and dot, integers are summed as 64-bit with wrap-around
+            template <class T>
+            using Accumulator = std::conditional_t<std::is_integral<T>::value, unsigned long long, T>;
+
+            template <class T, class Value>
+            Accumulator<T> accumulate(Accumulator<T> acc, Value v) noexcept {
+                return acc + static_cast<Accumulator<T>>(static_cast<SumType<T>>(v));
+            }
+
+            /// \brief combine vector lanes, then the remaining elements, in order
+            template <class T, class Lane>
+            SumType<T> sum_lanes(const Lane* lanes, size_t n_lanes, const T* p, size_t n) noexcept {
+                Accumulator<T> acc{};
+                for (size_t i = 0; i < n_lanes; ++i) {
+                    acc = accumulate<T>(acc, lanes[i]);
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    acc = accumulate<T>(acc, p[i]);
+                }
+                return static_cast<SumType<T>>(acc);
+            }
+
+            template <class T, class Lane>
+            SumType<T> dot_lanes(const Lane* lanes, size_t n_lanes, const T* a, const T* b, size_t n) noexcept {
+                Accumulator<T> acc{};
+                for (size_t i = 0; i < n_lanes; ++i) {
+                    acc = accumulate<T>(acc, lanes[i]);
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    acc += static_cast<Accumulator<T>>(a[i]) * static_cast<Accumulator<T>>(b[i]);
+                }
+                return static_cast<SumType<T>>(acc);
+            }
+
+            /// \brief same selection as the vector kernels: [v] if v < m, [m] otherwise
+            template <class T>
+            std::pair<T, T> minmax_lanes(const T* lo, const T* hi, size_t n_lanes, const T* p, size_t n) noexcept {
+                T min_value = lo[0], max_value = hi[0];
+                for (size_t i = 1; i < n_lanes; ++i) {
+                    min_value = lo[i] < min_value ? lo[i] : min_value;
+                    max_value = hi[i] > max_value ? hi[i] : max_value;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    min_value = p[i] < min_value ? p[i] : min_value;
+                    max_value = p[i] > max_value ? p[i] : max_value;
+                }
+                return {min_value, max_value};
+            }
+
+            struct ScalarKernels {
+                template <class T>
+                static SumType<T> sum(const T* p, size_t n) noexcept {
+                    return sum_lanes<T, T>(nullptr, 0, p, n);
+                }
+                template <class T>
+                static std::pair<T, T> minmax(const T* p, size_t n) noexcept {
+                    return minmax_lanes(p, p, 1, p + 1, n - 1);
+                }
+                template <class T>
+                static SumType<T> dot(const T* a, const T* b, size_t n) noexcept {
+                    return dot_lanes<T, T>(nullptr, 0, a, b, n);
+                }
+            };
+
+            inline Level detect_level() noexcept {
+#ifdef __TYPELESS_SIMD
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f")) {
+                    return Level::avx512;
+                }
+                if (__builtin_cpu_supports("avx2")) {
+                    return Level::avx2;
+                }
+                if (__builtin_cpu_supports("sse2")) {
+                    return Level::sse2;
+                }
+#endif
+                return Level::scalar;
+            }
+
+            inline std::atomic<int>& level_storage() noexcept {
+                static std::atomic<int> level{static_cast<int>(detected_level())};
+                return level;
+            }
+
+            /// \brief highest instruction set supported by the CPU, detected once
+            inline Level detected_level() noexcept {
+                static const Level level = detect_level();
+                return level;
+            }
+
+            /// \brief instruction set used by the kernels
+            inline Level level() noexcept {
+                return static_cast<Level>(level_storage().load(std::memory_order_relaxed));
+            }
+
+            /// \brief use at most [new_level], capped to detected_level(). Returns previous level.
+            inline Level set_level(Level new_level) noexcept {
+                int capped = std::min(static_cast<int>(new_level), static_cast<int>(detected_level()));
+                return static_cast<Level>(level_storage().exchange(capped, std::memory_order_relaxed));
+            }
+
+#ifdef __TYPELESS_SIMD
+// Kernels are stamped out once per instruction set, since the target of a function
+// cannot depend on a template parameter. [V] supplies the vector operations.
+#define __TYPELESS_SIMD_KERNELS(TARGET)                                                             \
+    template <class V, class T>                                                                     \
+    __attribute__((target(TARGET))) SumType<T> sum(const T* p, size_t n) noexcept {                 \
+        typename V::acc a0 = V::acc_zero(), a1 = V::acc_zero();                                     \
+        size_t i = 0;                                                                               \
+        for (; i + 2 * V::width <= n; i += 2 * V::width) {                                          \
+            a0 = V::accumulate(a0, p + i);                                                          \
+            a1 = V::accumulate(a1, p + i + V::width);                                               \
+        }                                                                                           \
+        if (i + V::width <= n) {                                                                    \
+            a0 = V::accumulate(a0, p + i);                                                          \
+            i += V::width;                                                                          \
+        }                                                                                           \
+        typename V::acc_value lanes[V::acc_width];                                                  \
+        V::store_acc(lanes, V::acc_add(a0, a1));                                                    \
+        return sum_lanes(lanes, V::acc_width, p + i, n - i);                                        \
+    }                                                                                               \
+                                                                                                    \
+    template <class V, class T>                                                                     \
+    __attribute__((target(TARGET))) std::pair<T, T> minmax(const T* p, size_t n) noexcept {         \
+        if (n < V::width) {                                                                         \
+            return ScalarKernels::minmax(p, n);                                                     \
+        }                                                                                           \
+        typename V::vec lo = V::load(p), hi = lo;                                                   \
+        size_t i = V::width;                                                                        \
+        for (; i + V::width <= n; i += V::width) {                                                  \
+            typename V::vec v = V::load(p + i);                                                     \
+            lo = V::min(v, lo);                                                                     \
+            hi = V::max(v, hi);                                                                     \
+        }                                                                                           \
+        T lo_lanes[V::width], hi_lanes[V::width];                                                   \
+        V::store(lo_lanes, lo);                                                                     \
+        V::store(hi_lanes, hi);                                                                     \
+        return minmax_lanes(lo_lanes, hi_lanes, V::width, p + i, n - i);                            \
+    }                                                                                               \
+                                                                                                    \
+    template <class V, class T>                                                                     \
+    __attribute__((target(TARGET))) SumType<T> dot(const T* a, const T* b, size_t n) noexcept {     \
+        typename V::acc s0 = V::acc_zero(), s1 = V::acc_zero();                                     \
+        size_t i = 0;                                                                               \
+        for (; i + 2 * V::width <= n; i += 2 * V::width) {                                          \
+            s0 = V::dot_accumulate(s0, a + i, b + i);                                               \
+            s1 = V::dot_accumulate(s1, a + i + V::width, b + i + V::width);                         \
+        }                                                                                           \
+        if (i + V::width <= n) {                                                                    \
+            s0 = V::dot_accumulate(s0, a + i, b + i);                                               \
+            i += V::width;                                                                          \
+        }                                                                                           \
+        typename V::acc_value lanes[V::acc_width];                                                  \
+        V::store_acc(lanes, V::acc_add(s0, s1));                                                    \
+        return dot_lanes(lanes, V::acc_width, a + i, b + i, n - i);                                 \
+    }
+
+#define __TYPELESS_SSE2 __attribute__((target("sse2"))) static
+            namespace sse2 {
+                /// \brief [v] where mask is set, [m] elsewhere
+                __attribute__((target("sse2"))) inline __m128i select(__m128i mask, __m128i v, __m128i m) {
+                    return _mm_or_si128(_mm_and_si128(mask, v), _mm_andnot_si128(mask, m));
+                }
+                /// \brief signed 64-bit a > b, SSE2 only compares 32-bit lanes
+                __attribute__((target("sse2"))) inline __m128i cmpgt_epi64(__m128i a, __m128i b) {
+                    __m128i r = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+                    r = _mm_or_si128(r, _mm_cmpgt_epi32(a, b));
+                    return _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 3, 1, 1));
+                }
+
+                struct F32 {
+                    using vec = __m128;
+                    using acc = __m128;
+                    using acc_value = float;
+                    static constexpr size_t width = 4, acc_width = 4;
+                    __TYPELESS_SSE2 vec load(const void* p) { return _mm_loadu_ps(static_cast<const float*>(p)); }
+                    __TYPELESS_SSE2 void store(void* p, vec v) { _mm_storeu_ps(static_cast<float*>(p), v); }
+                    __TYPELESS_SSE2 vec zero() { return _mm_setzero_ps(); }
+                    __TYPELESS_SSE2 vec add(vec a, vec b) { return _mm_add_ps(a, b); }
+                    __TYPELESS_SSE2 vec mul(vec a, vec b) { return _mm_mul_ps(a, b); }
+                    __TYPELESS_SSE2 vec min(vec v, vec m) { return _mm_min_ps(v, m); }
+                    __TYPELESS_SSE2 vec max(vec v, vec m) { return _mm_max_ps(v, m); }
+                    __TYPELESS_SSE2 acc acc_zero() { return zero(); }
+                    __TYPELESS_SSE2 acc acc_add(acc a, acc b) { return add(a, b); }
+                    __TYPELESS_SSE2 acc accumulate(acc a, const void* p) { return add(a, load(p)); }
+                    __TYPELESS_SSE2 acc dot_accumulate(acc s, const void* a, const void* b) { return add(s, mul(load(a), load(b))); }
+                    __TYPELESS_SSE2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct F64 {
+                    using vec = __m128d;
+                    using acc = __m128d;
+                    using acc_value = double;
+                    static constexpr size_t width = 2, acc_width = 2;
+                    __TYPELESS_SSE2 vec load(const void* p) { return _mm_loadu_pd(static_cast<const double*>(p)); }
+                    __TYPELESS_SSE2 void store(void* p, vec v) { _mm_storeu_pd(static_cast<double*>(p), v); }
+                    __TYPELESS_SSE2 vec zero() { return _mm_setzero_pd(); }
+                    __TYPELESS_SSE2 vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+                    __TYPELESS_SSE2 vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+                    __TYPELESS_SSE2 vec min(vec v, vec m) { return _mm_min_pd(v, m); }
+                    __TYPELESS_SSE2 vec max(vec v, vec m) { return _mm_max_pd(v, m); }
+                    __TYPELESS_SSE2 acc acc_zero() { return zero(); }
+                    __TYPELESS_SSE2 acc acc_add(acc a, acc b) { return add(a, b); }
+                    __TYPELESS_SSE2 acc accumulate(acc a, const void* p) { return add(a, load(p)); }
+                    __TYPELESS_SSE2 acc dot_accumulate(acc s, const void* a, const void* b) { return add(s, mul(load(a), load(b))); }
+                    __TYPELESS_SSE2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct I32 {
+                    using vec = __m128i;
+                    using acc = __m128i; // 2 x int64
+                    using acc_value = std::int64_t;
+                    static constexpr size_t width = 4, acc_width = 2;
+                    __TYPELESS_SSE2 vec load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+                    __TYPELESS_SSE2 void store(void* p, vec v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+                    __TYPELESS_SSE2 vec min(vec v, vec m) { return select(_mm_cmplt_epi32(v, m), v, m); }
+                    __TYPELESS_SSE2 vec max(vec v, vec m) { return select(_mm_cmpgt_epi32(v, m), v, m); }
+                    __TYPELESS_SSE2 acc acc_zero() { return _mm_setzero_si128(); }
+                    __TYPELESS_SSE2 acc acc_add(acc a, acc b) { return _mm_add_epi64(a, b); }
+                    /// \brief sign extend to 64-bit lanes before adding
+                    __TYPELESS_SSE2 acc accumulate(acc a, const void* p) {
+                        vec v = load(p);
+                        vec sign = _mm_srai_epi32(v, 31);
+                        return _mm_add_epi64(a, _mm_add_epi64(_mm_unpacklo_epi32(v, sign), _mm_unpackhi_epi32(v, sign)));
+                    }
+                    __TYPELESS_SSE2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct I64 {
+                    using vec = __m128i;
+                    using acc = __m128i;
+                    using acc_value = std::int64_t;
+                    static constexpr size_t width = 2, acc_width = 2;
+                    __TYPELESS_SSE2 vec load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+                    __TYPELESS_SSE2 void store(void* p, vec v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+                    __TYPELESS_SSE2 vec min(vec v, vec m) { return select(cmpgt_epi64(m, v), v, m); }
+                    __TYPELESS_SSE2 vec max(vec v, vec m) { return select(cmpgt_epi64(v, m), v, m); }
+                    __TYPELESS_SSE2 acc acc_zero() { return _mm_setzero_si128(); }
+                    __TYPELESS_SSE2 acc acc_add(acc a, acc b) { return _mm_add_epi64(a, b); }
+                    __TYPELESS_SSE2 acc accumulate(acc a, const void* p) { return _mm_add_epi64(a, load(p)); }
+                    __TYPELESS_SSE2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                __TYPELESS_SIMD_KERNELS("sse2")
+            } // namespace sse2
+#undef __TYPELESS_SSE2
+
+#define __TYPELESS_AVX2 __attribute__((target("avx2"))) static
+            namespace avx2 {
+                struct F32 {
+                    using vec = __m256;
+                    using acc = __m256;
+                    using acc_value = float;
+                    static constexpr size_t width = 8, acc_width = 8;
+                    __TYPELESS_AVX2 vec load(const void* p) { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+                    __TYPELESS_AVX2 void store(void* p, vec v) { _mm256_storeu_ps(static_cast<float*>(p), v); }
+                    __TYPELESS_AVX2 vec zero() { return _mm256_setzero_ps(); }
+                    __TYPELESS_AVX2 vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+                    __TYPELESS_AVX2 vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+                    __TYPELESS_AVX2 vec min(vec v, vec m) { return _mm256_min_ps(v, m); }
+                    __TYPELESS_AVX2 vec max(vec v, vec m) { return _mm256_max_ps(v, m); }
+                    __TYPELESS_AVX2 acc acc_zero() { return zero(); }
+                    __TYPELESS_AVX2 acc acc_add(acc a, acc b) { return add(a, b); }
+                    __TYPELESS_AVX2 acc accumulate(acc a, const void* p) { return add(a, load(p)); }
+                    __TYPELESS_AVX2 acc dot_accumulate(acc s, const void* a, const void* b) { return add(s, mul(load(a), load(b))); }
+                    __TYPELESS_AVX2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct F64 {
+                    using vec = __m256d;
+                    using acc = __m256d;
+                    using acc_value = double;
+                    static constexpr size_t width = 4, acc_width = 4;
+                    __TYPELESS_AVX2 vec load(const void* p) { return _mm256_loadu_pd(static_cast<const double*>(p)); }
+                    __TYPELESS_AVX2 void store(void* p, vec v) { _mm256_storeu_pd(static_cast<double*>(p), v); }
+                    __TYPELESS_AVX2 vec zero() { return _mm256_setzero_pd(); }
+                    __TYPELESS_AVX2 vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+                    __TYPELESS_AVX2 vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+                    __TYPELESS_AVX2 vec min(vec v, vec m) { return _mm256_min_pd(v, m); }
+                    __TYPELESS_AVX2 vec max(vec v, vec m) { return _mm256_max_pd(v, m); }
+                    __TYPELESS_AVX2 acc acc_zero() { return zero(); }
+                    __TYPELESS_AVX2 acc acc_add(acc a, acc b) { return add(a, b); }
+                    __TYPELESS_AVX2 acc accumulate(acc a, const void* p) { return add(a, load(p)); }
+                    __TYPELESS_AVX2 acc dot_accumulate(acc s, const void* a, const void* b) { return add(s, mul(load(a), load(b))); }
+                    __TYPELESS_AVX2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct I32 {
+                    using vec = __m256i;
+                    using acc = __m256i; // 4 x int64
+                    using acc_value = std::int64_t;
+                    static constexpr size_t width = 8, acc_width = 4;
+                    __TYPELESS_AVX2 vec load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+                    __TYPELESS_AVX2 void store(void* p, vec v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+                    __TYPELESS_AVX2 vec min(vec v, vec m) { return _mm256_min_epi32(v, m); }
+                    __TYPELESS_AVX2 vec max(vec v, vec m) { return _mm256_max_epi32(v, m); }
+                    __TYPELESS_AVX2 acc acc_zero() { return _mm256_setzero_si256(); }
+                    __TYPELESS_AVX2 acc acc_add(acc a, acc b) { return _mm256_add_epi64(a, b); }
+                    __TYPELESS_AVX2 acc accumulate(acc a, const void* p) {
+                        vec v = load(p);
+                        acc lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v));
+                        acc hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1));
+                        return _mm256_add_epi64(a, _mm256_add_epi64(lo, hi));
+                    }
+                    /// \brief 64-bit products of even lanes, then of odd lanes shifted down
+                    __TYPELESS_AVX2 acc dot_accumulate(acc s, const void* a, const void* b) {
+                        vec x = load(a), y = load(b);
+                        acc even = _mm256_mul_epi32(x, y);
+                        acc odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+                        return _mm256_add_epi64(s, _mm256_add_epi64(even, odd));
+                    }
+                    __TYPELESS_AVX2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct I64 {
+                    using vec = __m256i;
+                    using acc = __m256i;
+                    using acc_value = std::int64_t;
+                    static constexpr size_t width = 4, acc_width = 4;
+                    __TYPELESS_AVX2 vec load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+                    __TYPELESS_AVX2 void store(void* p, vec v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+                    __TYPELESS_AVX2 vec min(vec v, vec m) { return _mm256_blendv_epi8(m, v, _mm256_cmpgt_epi64(m, v)); }
+                    __TYPELESS_AVX2 vec max(vec v, vec m) { return _mm256_blendv_epi8(m, v, _mm256_cmpgt_epi64(v, m)); }
+                    __TYPELESS_AVX2 acc acc_zero() { return _mm256_setzero_si256(); }
+                    __TYPELESS_AVX2 acc acc_add(acc a, acc b) { return _mm256_add_epi64(a, b); }
+                    __TYPELESS_AVX2 acc accumulate(acc a, const void* p) { return _mm256_add_epi64(a, load(p)); }
+                    /// \brief low 64 bits of the products from three 32 x 32 -> 64-bit multiplies,
+                    ///        a 64-bit multiply needs AVX-512DQ
+                    __TYPELESS_AVX2 acc dot_accumulate(acc s, const void* a, const void* b) {
+                        vec x = load(a), y = load(b);
+                        vec cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), y), _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32)));
+                        return _mm256_add_epi64(s, _mm256_add_epi64(_mm256_mul_epu32(x, y), _mm256_slli_epi64(cross, 32)));
+                    }
+                    __TYPELESS_AVX2 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                __TYPELESS_SIMD_KERNELS("avx2")
+            } // namespace avx2
+#undef __TYPELESS_AVX2
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+// intrinsics of GCC 12 pass _mm512_undefined_* as merge source, which is reported once inlined
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#define __TYPELESS_AVX512 __attribute__((target("avx512f"))) static
+            namespace avx512 {
+                struct F32 {
+                    using vec = __m512;
+                    using acc = __m512;
+                    using acc_value = float;
+                    static constexpr size_t width = 16, acc_width = 16;
+                    __TYPELESS_AVX512 vec load(const void* p) { return _mm512_loadu_ps(p); }
+                    __TYPELESS_AVX512 void store(void* p, vec v) { _mm512_storeu_ps(p, v); }
+                    __TYPELESS_AVX512 vec zero() { return _mm512_setzero_ps(); }
+                    __TYPELESS_AVX512 vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+                    __TYPELESS_AVX512 vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+                    __TYPELESS_AVX512 vec min(vec v, vec m) { return _mm512_min_ps(v, m); }
+                    __TYPELESS_AVX512 vec max(vec v, vec m) { return _mm512_max_ps(v, m); }
+                    __TYPELESS_AVX512 acc acc_zero() { return zero(); }
+                    __TYPELESS_AVX512 acc acc_add(acc a, acc b) { return add(a, b); }
+                    __TYPELESS_AVX512 acc accumulate(acc a, const void* p) { return add(a, load(p)); }
+                    __TYPELESS_AVX512 acc dot_accumulate(acc s, const void* a, const void* b) { return add(s, mul(load(a), load(b))); }
+                    __TYPELESS_AVX512 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct F64 {
+                    using vec = __m512d;
+                    using acc = __m512d;
+                    using acc_value = double;
+                    static constexpr size_t width = 8, acc_width = 8;
+                    __TYPELESS_AVX512 vec load(const void* p) { return _mm512_loadu_pd(p); }
+                    __TYPELESS_AVX512 void store(void* p, vec v) { _mm512_storeu_pd(p, v); }
+                    __TYPELESS_AVX512 vec zero() { return _mm512_setzero_pd(); }
+                    __TYPELESS_AVX512 vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+                    __TYPELESS_AVX512 vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+                    __TYPELESS_AVX512 vec min(vec v, vec m) { return _mm512_min_pd(v, m); }
+                    __TYPELESS_AVX512 vec max(vec v, vec m) { return _mm512_max_pd(v, m); }
+                    __TYPELESS_AVX512 acc acc_zero() { return zero(); }
+                    __TYPELESS_AVX512 acc acc_add(acc a, acc b) { return add(a, b); }
+                    __TYPELESS_AVX512 acc accumulate(acc a, const void* p) { return add(a, load(p)); }
+                    __TYPELESS_AVX512 acc dot_accumulate(acc s, const void* a, const void* b) { return add(s, mul(load(a), load(b))); }
+                    __TYPELESS_AVX512 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct I32 {
+                    using vec = __m512i;
+                    using acc = __m512i; // 8 x int64
+                    using acc_value = std::int64_t;
+                    static constexpr size_t width = 16, acc_width = 8;
+                    __TYPELESS_AVX512 vec load(const void* p) { return _mm512_loadu_si512(p); }
+                    __TYPELESS_AVX512 void store(void* p, vec v) { _mm512_storeu_si512(p, v); }
+                    __TYPELESS_AVX512 vec min(vec v, vec m) { return _mm512_min_epi32(v, m); }
+                    __TYPELESS_AVX512 vec max(vec v, vec m) { return _mm512_max_epi32(v, m); }
+                    __TYPELESS_AVX512 acc acc_zero() { return _mm512_setzero_si512(); }
+                    __TYPELESS_AVX512 acc acc_add(acc a, acc b) { return _mm512_add_epi64(a, b); }
+                    __TYPELESS_AVX512 acc accumulate(acc a, const void* p) {
+                        vec v = load(p);
+                        acc lo = _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v));
+                        acc hi = _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1));
+                        return _mm512_add_epi64(a, _mm512_add_epi64(lo, hi));
+                    }
+                    __TYPELESS_AVX512 acc dot_accumulate(acc s, const void* a, const void* b) {
+                        vec x = load(a), y = load(b);
+                        acc even = _mm512_mul_epi32(x, y);
+                        acc odd = _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32));
+                        return _mm512_add_epi64(s, _mm512_add_epi64(even, odd));
+                    }
+                    __TYPELESS_AVX512 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                struct I64 {
+                    using vec = __m512i;
+                    using acc = __m512i;
+                    using acc_value = std::int64_t;
+                    static constexpr size_t width = 8, acc_width = 8;
+                    __TYPELESS_AVX512 vec load(const void* p) { return _mm512_loadu_si512(p); }
+                    __TYPELESS_AVX512 void store(void* p, vec v) { _mm512_storeu_si512(p, v); }
+                    __TYPELESS_AVX512 vec min(vec v, vec m) { return _mm512_min_epi64(v, m); }
+                    __TYPELESS_AVX512 vec max(vec v, vec m) { return _mm512_max_epi64(v, m); }
+                    __TYPELESS_AVX512 acc acc_zero() { return _mm512_setzero_si512(); }
+                    __TYPELESS_AVX512 acc acc_add(acc a, acc b) { return _mm512_add_epi64(a, b); }
+                    __TYPELESS_AVX512 acc accumulate(acc a, const void* p) { return _mm512_add_epi64(a, load(p)); }
+                    __TYPELESS_AVX512 acc dot_accumulate(acc s, const void* a, const void* b) {
+                        vec x = load(a), y = load(b);
+                        vec cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(x, 32), y), _mm512_mul_epu32(x, _mm512_srli_epi64(y, 32)));
+                        return _mm512_add_epi64(s, _mm512_add_epi64(_mm512_mul_epu32(x, y), _mm512_slli_epi64(cross, 32)));
+                    }
+                    __TYPELESS_AVX512 void store_acc(acc_value* p, acc a) { store(p, a); }
+                };
+
+                __TYPELESS_SIMD_KERNELS("avx512f")
+            } // namespace avx512
+#undef __TYPELESS_AVX512
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#undef __TYPELESS_SIMD_KERNELS
+
+            /// \brief kernels of one element type, chosen by level() on every call
+            template <class Sse2, class Avx2, class Avx512>
+            struct DispatchKernels {
+                template <class T>
+                static SumType<T> sum(const T* p, size_t n) noexcept {
+                    switch (level()) {
+                    case Level::avx512: return avx512::sum<Avx512>(p, n);
+                    case Level::avx2: return avx2::sum<Avx2>(p, n);
+                    case Level::sse2: return sse2::sum<Sse2>(p, n);
+                    default: return ScalarKernels::sum(p, n);
+                    }
+                }
+                template <class T>
+                static std::pair<T, T> minmax(const T* p, size_t n) noexcept {
+                    switch (level()) {
+                    case Level::avx512: return avx512::minmax<Avx512>(p, n);
+                    case Level::avx2: return avx2::minmax<Avx2>(p, n);
+                    case Level::sse2: return sse2::minmax<Sse2>(p, n);
+                    default: return ScalarKernels::minmax(p, n);
+                    }
+                }
+                template <class T>
+                static SumType<T> dot(const T* a, const T* b, size_t n) noexcept {
+                    switch (level()) {
+                    case Level::avx512: return avx512::dot<Avx512>(a, b, n);
+                    case Level::avx2: return avx2::dot<Avx2>(a, b, n);
+                    case Level::sse2: return sse2_dot(a, b, n, std::is_floating_point<T>{});
+                    default: return ScalarKernels::dot(a, b, n);
+                    }
+                }
+                template <class T>
+                static SumType<T> sse2_dot(const T* a, const T* b, size_t n, std::true_type) noexcept {
+                    return sse2::dot<Sse2>(a, b, n);
+                }
+                /// \brief _mm_mul_epi32 needs SSE4.1, building 64-bit products from _mm_mul_epu32 is slower than scalar
+                template <class T>
+                static SumType<T> sse2_dot(const T* a, const T* b, size_t n, std::false_type) noexcept {
+                    return ScalarKernels::dot(a, b, n);
+                }
+            };
+
+            template <class T>
+            using Kernels = std::conditional_t<
+                std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4,
+                DispatchKernels<sse2::I32, avx2::I32, avx512::I32>,
+                std::conditional_t<
+                    std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 8,
+                    DispatchKernels<sse2::I64, avx2::I64, avx512::I64>,
+                    std::conditional_t<
+                        std::is_same<T, float>::value, DispatchKernels<sse2::F32, avx2::F32, avx512::F32>,
+                        std::conditional_t<std::is_same<T, double>::value,
+                                           DispatchKernels<sse2::F64, avx2::F64, avx512::F64>,
+                                           ScalarKernels>>>>;
+#else
+            template <class T>
+            using Kernels = ScalarKernels;
+#endif
+
+            template <class T>
+            SumType<T> sum(const T* p, size_t n) noexcept {
+                return Kernels<T>::sum(p, n);
+            }
+
+            template <class T>
+            std::pair<T, T> minmax(const T* p, size_t n) noexcept {
+                assert(n > 0);
+                return Kernels<T>::minmax(p, n);
+            }
+
+            template <class T>
+            SumType<T> dot(const T* a, const T* b, size_t n) noexcept {
+                return Kernels<T>::dot(a, b, n);
+            }
+        } // namespace simd
+    } // namespace internal
+#pragma endregion SimdImpl
+
+#pragma region InternalImpl
+    namespace internal {
+        template <class T, class EqualTo>
+        struct HasOperatorEqualImpl {
             template <class U, class V>
             static auto test(U*) -> decltype(std::declval<U>() == std::declval<V>());
             template <typename, typename>
@@ -637,176 +3906,921 @@ namespace typeless {
             return false;
         }
 
+        template <class T>
+        struct HasStdHashImpl {
+            template <class U>
+            static auto test(U*) -> decltype(std::hash<U>()(std::declval<const U&>()));
+            template <typename>
+            static auto test(...) -> std::false_type;
+
+            using type =
+                typename std::is_same<size_t, decltype(test<T>(nullptr))>::type;
+        };
+
+        template <class T>
+        struct HasStdHash : HasStdHashImpl<T>::type {
+        };
+
+        /// \brief true if value initialized T is all zero bytes, so it can be filled by memset
+        template <class T>
+        struct IsZeroInitializable
+            : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                                               std::is_pointer<T>::value ||
+                                               std::is_same<T, std::nullptr_t>::value> {
+        };
+
+        template <class Allocator_, class T>
+        struct HasReallocateImpl {
+            template <class A>
+            static auto test(A* a) -> decltype(a->reallocate(std::declval<T*>(), size_t(), size_t()));
+            template <typename>
+            static auto test(...) -> std::false_type;
+
+            using type = typename std::is_same<T*, decltype(test<Allocator_>(nullptr))>::type;
+        };
+
+        /// \brief true if Allocator_ can grow a block of trivially copyable T in place,
+        ///        through a member T* reallocate(T* ptr, size_t old_n, size_t new_n)
+        template <class Allocator_, class T>
+        struct HasReallocate
+            : std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                               HasReallocateImpl<Allocator_, T>::type::value> {
+        };
+
+        template <class T, typename std::enable_if_t<HasStdHash<T>::value, int> = 0>
+        size_t HashHelper(const void* ptr) {
+            return std::hash<T>()(*static_cast<const T*>(ptr));
+        }
+
+        /// \brief values without std::hash are only distinguished by type,
+        ///        so all values of such a type collide in hashed containers
+        template <class T, typename std::enable_if_t<!HasStdHash<T>::value, int> = 0>
+        size_t HashHelper(const void*) {
+            return 0;
+        }
+
+        /// \brief integers are formatted as the widest integer of same signedness
+        template <class T>
+        using FormatType = std::conditional_t<
+            std::is_integral<T>::value,
+            std::conditional_t<std::is_signed<T>::value, long long, unsigned long long>,
+            T>;
+
+#ifdef __cpp_lib_to_chars
+        template <class T>
+        char* format_number(char* first, char* last, T value) noexcept {
+            return std::to_chars(first, last, static_cast<FormatType<T>>(value)).ptr;
+        }
+#else
+        inline char* format_number(char* first, char* last, long long value) noexcept {
+            return first + std::snprintf(first, last - first, "%lld", value);
+        }
+
+        inline char* format_number(char* first, char* last, unsigned long long value) noexcept {
+            return first + std::snprintf(first, last - first, "%llu", value);
+        }
+
+        /// \brief shortest "%g" precision that reads back to [value]
+        template <class T>
+        char* format_float(char* first, char* last, T value, int max_precision) noexcept {
+            int n = 0;
+            for (int precision = 1; precision <= max_precision; ++precision) {
+                n = std::snprintf(first, last - first, "%.*Lg", precision, static_cast<long double>(value));
+                if (static_cast<T>(std::strtold(first, nullptr)) == value) {
+                    break;
+                }
+            }
+            return first + n;
+        }
+
+        inline char* format_number(char* first, char* last, float value) noexcept {
+            return format_float(first, last, value, 9);
+        }
+
+        inline char* format_number(char* first, char* last, double value) noexcept {
+            return format_float(first, last, value, 17);
+        }
+
+        inline char* format_number(char* first, char* last, long double value) noexcept {
+            return format_float(first, last, value, 21);
+        }
+
+        template <class T>
+        char* format_number(char* first, char* last, T value) noexcept {
+            return format_number(first, last, static_cast<FormatType<T>>(value));
+        }
+#endif
+
+        /// \brief true if equal values of T have equal bytes
+        template <class T>
+        struct HasUniqueRepresentation
+            : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value ||
+                                               std::is_pointer<T>::value> {
+        };
+
+        inline size_t hash_combine(size_t seed, size_t h) noexcept {
+            return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+        }
+
+        inline std::uint64_t rotl64(std::uint64_t x, int r) noexcept {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        inline std::uint64_t read64(const unsigned char* p) noexcept {
+            std::uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        /// \brief xxHash64 style hash of a byte range.
+        ///        Blocks of 32 bytes are mixed into 4 independent lanes.
+        inline size_t hash_bytes(const void* data, size_t len) noexcept {
+            constexpr std::uint64_t P1 = 11400714785074694791ull, P2 = 14029467366897019727ull,
+                                    P3 = 1609587929392839161ull, P4 = 9650029242287828579ull,
+                                    P5 = 2870177450012600261ull;
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            const unsigned char* const end = p + len;
+            std::uint64_t h;
+            if (len >= 32) {
+                std::uint64_t lanes[4] = {P1 + P2, P2, 0, 0 - P1};
+                do {
+                    for (int i = 0; i < 4; ++i) {
+                        lanes[i] = rotl64(lanes[i] + read64(p + i * 8) * P2, 31) * P1;
+                    }
+                    p += 32;
+                } while (end - p >= 32);
+                h = rotl64(lanes[0], 1) + rotl64(lanes[1], 7) + rotl64(lanes[2], 12) + rotl64(lanes[3], 18);
+                for (std::uint64_t lane : lanes) {
+                    h = (h ^ (rotl64(lane * P2, 31) * P1)) * P1 + P4;
+                }
+            } else {
+                h = P5;
+            }
+            h += len;
+            for (; end - p >= 8; p += 8) {
+                h ^= rotl64(read64(p) * P2, 31) * P1;
+                h = rotl64(h, 27) * P1 + P4;
+            }
+            for (; p != end; ++p) {
+                h ^= *p * P5;
+                h = rotl64(h, 11) * P1;
+            }
+            h ^= h >> 33;
+            h *= P2;
+            h ^= h >> 29;
+            h *= P3;
+            h ^= h >> 32;
+            return static_cast<size_t>(h);
+        }
+
+        /// \brief allocator used by helpers of an allocator type.
+        ///        Stateless allocators are constructed on use, stateful ones are shared.
+        template <class Allocator_, bool = std::is_empty<Allocator_>::value>
+        struct AllocatorInstance {
+            static Allocator_& get() {
+                static Allocator_ allocator;
+                return allocator;
+            }
+        };
+
+        template <class Allocator_>
+        struct AllocatorInstance<Allocator_, true> {
+            static Allocator_ get() { return Allocator_(); }
+        };
+
         template <class T, class Allocator_>
-        class TypedObjectHelperBase : public ObjectHelper {
-            Allocator_ allocator;
-            void* get_allocator() override { return &allocator; }
-            void* allocate() override { return allocator.allocate(1); }
-            void destroy_deallocate(void* ptr) override {
+        struct TypedObjectHelperBase {
+            static decltype(auto) allocator() { return AllocatorInstance<Allocator_>::get(); }
+
+            /// \brief construct T from [args] in [storage] if it fits, on heap otherwise
+            template <class... Args>
+            static void* emplace(void* storage, Args&&... args) {
+                T* ptr = IsInlineObject<T>::value ? static_cast<T*>(storage) : allocator().allocate(1);
+                try {
+                    ::new (ptr) T(std::forward<Args>(args)...);
+                } catch (...) {
+                    if (!IsInlineObject<T>::value) {
+                        allocator().deallocate(ptr, 1);
+                    }
+                    throw;
+                }
+                return ptr;
+            }
+
+            static void* get_allocator() { return &AllocatorInstance<Allocator_, false>::get(); }
+            static void* allocate() { return allocator().allocate(1); }
+            static void destroy_deallocate(void* ptr) {
                 internal::destroy_at(static_cast<T*>(ptr));
-                allocator.deallocate(static_cast<T*>(ptr), 1);
+                if (!IsInlineObject<T>::value) {
+                    allocator().deallocate(static_cast<T*>(ptr), 1);
+                }
+            }
+            static void* make_copy(void* storage, const void* src) {
+                return emplace(storage, *static_cast<const T*>(src));
+            }
+            static void* make_move(void* storage, void* src) {
+                return emplace(storage, std::move(*static_cast<T*>(src)));
+            }
+            static void* relocate(void* storage, void* src) {
+                return relocate(storage, src, IsInlineObject<T>{});
             }
-            void* make_copy(const void* src) override {
-                T* ptr = allocator.allocate(1);
-                internal::copy_construct_at(ptr, *static_cast<const T*>(src));
+            static void* relocate(void* storage, void* src, std::true_type) {
+                T* ptr = static_cast<T*>(storage);
+                internal::move_construct_at(ptr, *static_cast<T*>(src));
+                internal::destroy_at(static_cast<T*>(src));
                 return ptr;
             }
-            bool equal(const void* lhs, const void* rhs) override { return false; }
-            string to_string(const void* ptr) override {
-                return stringizer::to_string(*static_cast<const T*>(ptr));
+            static void* relocate(void*, void* src, std::false_type) {
+                return src; // heap values are moved by pointer
+            }
+            static void copy_assign(void* dst, const void* src) {
+                internal::assign_value<T>(dst, *static_cast<const T*>(src), std::is_copy_assignable<T>{});
+            }
+            static void copy_construct(void* dst, const void* src) {
+                internal::copy_construct_at(static_cast<T*>(dst), *static_cast<const T*>(src));
+            }
+            static void destruct(void* ptr) { internal::destroy_at(static_cast<T*>(ptr)); }
+            static constexpr auto copy_assign_fn() {
+                return std::is_copy_assignable<T>::value ? &copy_assign : nullptr;
+            }
+            static bool equal(const void* lhs, const void* rhs) { return false; }
+            static size_t hash(const void* ptr) { return HashHelper<T>(ptr); }
+            static void append_to(string& out, const void* ptr) {
+                stringizer::append_to(out, *static_cast<const T*>(ptr));
             }
-            const type_info* type() override { return &typeid(T); }
-            std::runtime_error exception() {
+            static std::runtime_error exception() {
                 return std::runtime_error(
                     string("Attempt to call arithmetic operand on non-arithmetic type ") +
-                    type()->name());
+                    typeid(T).name());
             }
-            bool less(const void*, const void*) override { throw exception(); }
-            Object sum(const void* a, const void* b) override { throw exception(); }
-            Object difference(const void* a, const void* b) override {
+            static bool less(const void*, const void*) { throw exception(); }
+            static Object sum(const void* a, const void* b) { throw exception(); }
+            static Object difference(const void* a, const void* b) {
                 throw exception();
             }
-            Object product(const void* a, const void* b) override { throw exception(); }
-            Object quotient(const void* a, const void* b) override {
+            static Object product(const void* a, const void* b) { throw exception(); }
+            static Object quotient(const void* a, const void* b) {
                 throw exception();
             }
+            static void sum_assign(void*, const void*) { throw exception(); }
+            static void difference_assign(void*, const void*) { throw exception(); }
+            static void product_assign(void*, const void*) { throw exception(); }
+            static void quotient_assign(void*, const void*) { throw exception(); }
+        };
+
+        template <class... Ts>
+        struct TypeList {
+            static constexpr size_t size = sizeof...(Ts);
+        };
+
+        /// \brief 1-based index of T in TList, 0 if absent
+        template <class T, class TList>
+        struct TypeIndex;
+
+        template <class T>
+        struct TypeIndex<T, TypeList<>> : std::integral_constant<size_t, 0> {
+        };
+
+        template <class T, class... Ts>
+        struct TypeIndex<T, TypeList<T, Ts...>> : std::integral_constant<size_t, 1> {
         };
 
+        template <class T, class U, class... Ts>
+        struct TypeIndex<T, TypeList<U, Ts...>>
+            : std::integral_constant<size_t, TypeIndex<T, TypeList<Ts...>>::value == 0
+                                                 ? 0
+                                                 : TypeIndex<T, TypeList<Ts...>>::value + 1> {
+        };
+
+        using ArithmeticTypes = TypeList<bool, char, signed char, unsigned char, wchar_t, char16_t, char32_t,
+                                         short, unsigned short, int, unsigned int, long, unsigned long,
+                                         long long, unsigned long long, float, double, long double>;
+
         template <class T, class Allocator_, int = std::is_arithmetic<T>::value>
-        class TypedObjectHelperArith;
+        struct TypedObjectHelperArith;
 
         template <class T, class Allocator_>
-        class TypedObjectHelperArith<T, Allocator_, 0>
-            : public TypedObjectHelperBase<T, Allocator_> {
+        struct TypedObjectHelperArith<T, Allocator_, 0>
+            : TypedObjectHelperBase<T, Allocator_> {
+            static constexpr unsigned char arith_index = 0;
         };
 
+        /// \brief arithmetic types missing in ArithmeticTypes (e.g. __int128, char8_t)
+        ///        keep their own operators but are not promoted against other types
         template <class T, class Allocator_>
-        class TypedObjectHelperArith<T, Allocator_, 1>
-            : public TypedObjectHelperBase<T, Allocator_> {
+        struct TypedObjectHelperArith<T, Allocator_, 1>
+            : TypedObjectHelperBase<T, Allocator_> {
+            static constexpr unsigned char arith_index = TypeIndex<T, ArithmeticTypes>::value;
+
             inline static const T& val(const void* v) {
                 return *static_cast<const T*>(v);
             }
-            bool less(const void* a, const void* b) override { return val(a) < val(b); }
-            Object sum(const void* a, const void* b) override {
+            inline static T& ref(void* v) {
+                return *static_cast<T*>(v);
+            }
+            /// \brief promotable values hash by value, so that equal values of different types collide
+            static size_t hash(const void* ptr) {
+                return hash_value(ptr, std::integral_constant<bool, arith_index != 0>{});
+            }
+            static size_t hash_value(const void* ptr, std::true_type) {
+                return std::hash<double>()(static_cast<double>(val(ptr)));
+            }
+            static size_t hash_value(const void* ptr, std::false_type) { return HashHelper<T>(ptr); }
+            static bool less(const void* a, const void* b) { return val(a) < val(b); }
+            static Object sum(const void* a, const void* b) {
                 return {val(a) + val(b)};
             }
-            Object difference(const void* a, const void* b) override {
+            static Object difference(const void* a, const void* b) {
                 return {val(a) - val(b)};
             }
-            Object product(const void* a, const void* b) override {
+            static Object product(const void* a, const void* b) {
                 return {val(a) * val(b)};
             }
-            Object quotient(const void* a, const void* b) override {
+            static Object quotient(const void* a, const void* b) {
                 return {val(a) / val(b)};
             }
+            static void sum_assign(void* a, const void* b) { ref(a) = static_cast<T>(val(a) + val(b)); }
+            static void difference_assign(void* a, const void* b) { ref(a) = static_cast<T>(val(a) - val(b)); }
+            static void product_assign(void* a, const void* b) { ref(a) = static_cast<T>(val(a) * val(b)); }
+            static void quotient_assign(void* a, const void* b) { ref(a) = static_cast<T>(val(a) / val(b)); }
+        };
+
+        /// \brief 0: floating point, compared in at least double precision
+        ///        1: integers of same signedness, 2: signed L and unsigned R, 3: unsigned L and signed R
+        template <class L, class R>
+        using CompareMode = std::integral_constant<
+            int, !(std::is_integral<L>::value && std::is_integral<R>::value) ? 0
+                 : std::is_signed<L>::value == std::is_signed<R>::value  ? 1
+                 : std::is_signed<L>::value                              ? 2
+                                                                         : 3>;
+
+        /// \brief integers compare by value, unlike built-in operators on mixed signedness
+        template <class L, class R>
+        bool promoted_less(L l, R r, std::integral_constant<int, 0>) {
+            using Common = std::common_type_t<L, R, double>;
+            return static_cast<Common>(l) < static_cast<Common>(r);
+        }
+        template <class L, class R>
+        bool promoted_less(L l, R r, std::integral_constant<int, 1>) { return l < r; }
+        template <class L, class R>
+        bool promoted_less(L l, R r, std::integral_constant<int, 2>) {
+            return l < 0 || static_cast<std::make_unsigned_t<L>>(l) < r;
+        }
+        template <class L, class R>
+        bool promoted_less(L l, R r, std::integral_constant<int, 3>) {
+            return r > 0 && l < static_cast<std::make_unsigned_t<R>>(r);
+        }
+
+        template <class L, class R>
+        bool promoted_equal(L l, R r, std::integral_constant<int, 0>) {
+            using Common = std::common_type_t<L, R, double>;
+            return static_cast<Common>(l) == static_cast<Common>(r);
+        }
+        template <class L, class R>
+        bool promoted_equal(L l, R r, std::integral_constant<int, 1>) { return l == r; }
+        template <class L, class R>
+        bool promoted_equal(L l, R r, std::integral_constant<int, 2>) {
+            return l >= 0 && static_cast<std::make_unsigned_t<L>>(l) == r;
+        }
+        template <class L, class R>
+        bool promoted_equal(L l, R r, std::integral_constant<int, 3>) {
+            return r >= 0 && l == static_cast<std::make_unsigned_t<R>>(r);
+        }
+
+        template <class L, class R>
+        struct TypedPromotedOps {
+            inline static const L& lval(const void* v) {
+                return *static_cast<const L*>(v);
+            }
+            inline static const R& rval(const void* v) {
+                return *static_cast<const R*>(v);
+            }
+            static bool less(const void* a, const void* b) {
+                return promoted_less(lval(a), rval(b), CompareMode<L, R>{});
+            }
+            static bool equal(const void* a, const void* b) {
+                return promoted_equal(lval(a), rval(b), CompareMode<L, R>{});
+            }
+            static Object sum(const void* a, const void* b) {
+                return {lval(a) + rval(b)};
+            }
+            static Object difference(const void* a, const void* b) {
+                return {lval(a) - rval(b)};
+            }
+            static Object product(const void* a, const void* b) {
+                return {lval(a) * rval(b)};
+            }
+            static Object quotient(const void* a, const void* b) {
+                return {lval(a) / rval(b)};
+            }
+            inline static L& lref(void* v) {
+                return *static_cast<L*>(v);
+            }
+            static void sum_assign(void* a, const void* b) { lref(a) = static_cast<L>(lval(a) + rval(b)); }
+            static void difference_assign(void* a, const void* b) { lref(a) = static_cast<L>(lval(a) - rval(b)); }
+            static void product_assign(void* a, const void* b) { lref(a) = static_cast<L>(lval(a) * rval(b)); }
+            static void quotient_assign(void* a, const void* b) { lref(a) = static_cast<L>(lval(a) / rval(b)); }
+            static constexpr PromotedOps value = {&less, &equal, &sum, &difference, &product, &quotient,
+                                                  &sum_assign, &difference_assign, &product_assign, &quotient_assign};
+        };
+
+        template <class L, class R>
+        constexpr PromotedOps TypedPromotedOps<L, R>::value;
+
+        /// \brief 2-D table of PromotedOps indexed by arith_index - 1
+        template <class TList>
+        struct PromotionTable;
+
+        template <class... Ts>
+        struct PromotionTable<TypeList<Ts...>> {
+            using Row = std::array<PromotedOps, sizeof...(Ts)>;
+            template <class L>
+            static constexpr Row row() {
+                return {{TypedPromotedOps<L, Ts>::value...}};
+            }
+            static constexpr std::array<Row, sizeof...(Ts)> value = {{row<Ts>()...}};
         };
 
+        template <class... Ts>
+        constexpr std::array<typename PromotionTable<TypeList<Ts...>>::Row, sizeof...(Ts)>
+            PromotionTable<TypeList<Ts...>>::value;
+
+        /// \brief type ids are equal for distinct types with the same spelled name,
+        ///        e.g. in anonymous namespaces of different translation units, so type_info decides then.
+        ///        Other types are told apart by the id alone.
+        template <class L, class R>
+        bool same_type(const L* l, const R* r) noexcept {
+            if (l == nullptr || r == nullptr) {
+                return l == nullptr && r == nullptr;
+            }
+            return l->type_id == r->type_id && (l->unique_type_id || l->type == r->type || *l->type == *r->type);
+        }
+
+        template <class T, class Helper>
+        bool has_type(const Helper* helper) noexcept {
+            if (helper == nullptr) {
+                return std::is_same<std::remove_cv_t<std::remove_reference_t<T>>, std::nullptr_t>::value;
+            }
+            return helper->type_id == type_id<T>() &&
+                   (unique_type_id<T>() || helper->type == &typeid(T) || *helper->type == typeid(T));
+        }
+
+        inline const PromotedOps* promoted_ops(const ObjectHelper* l, const ObjectHelper* r) noexcept {
+            if (l == nullptr || r == nullptr || l->arith_index == 0 || r->arith_index == 0) {
+                return nullptr;
+            }
+            return &PromotionTable<ArithmeticTypes>::value[l->arith_index - 1][r->arith_index - 1];
+        }
+
+        inline LessFn less_function(const ObjectHelper* l, const ObjectHelper* r) noexcept {
+            if (l != nullptr && same_type(l, r)) {
+                return l->less;
+            }
+            auto ops = promoted_ops(l, r);
+            return ops == nullptr ? nullptr : ops->less;
+        }
+
+        inline LessFn equal_function(const ObjectHelper* l, const ObjectHelper* r) noexcept {
+            if (l != nullptr && same_type(l, r)) {
+                return l->equal;
+            }
+            auto ops = promoted_ops(l, r);
+            return ops == nullptr ? nullptr : ops->equal;
+        }
+
         template <class T, class Allocator_, int = HasOperatorEqual<T>::value>
-        class TypedObjectHelper;
+        struct TypedObjectHelper;
 
         template <class T, class Allocator_>
-        class TypedObjectHelper<T, Allocator_, 0>
-            : public TypedObjectHelperArith<T, Allocator_> {
+        struct TypedObjectHelper<T, Allocator_, 0>
+            : TypedObjectHelperArith<T, Allocator_> {
         };
 
         template <class T, class Allocator_>
-        class TypedObjectHelper<T, Allocator_, 1>
-            : public TypedObjectHelperArith<T, Allocator_> {
-            bool equal(const void* lhs, const void* rhs) override {
+        struct TypedObjectHelper<T, Allocator_, 1>
+            : TypedObjectHelperArith<T, Allocator_> {
+            static bool equal(const void* lhs, const void* rhs) {
                 return *static_cast<const T*>(lhs) == *static_cast<const T*>(rhs);
             }
         };
 
         template <class T, class Allocator_>
-        class TypedArrayHelper : public ArrayHelper {
-            Allocator_ allocator;
-            void* get_allocator() override { return &allocator; }
+        struct ObjectHelperTable : TypedObjectHelper<T, Allocator_> {
+            using helper = TypedObjectHelper<T, Allocator_>;
+            static constexpr ObjectHelper value = {
+                &helper::get_allocator,
+                &helper::allocate,
+                &helper::destroy_deallocate,
+                &helper::make_copy,
+                &helper::make_move,
+                static_cast<void* (*)(void*, void*)>(&helper::relocate),
+                helper::copy_assign_fn(),
+                &helper::copy_construct,
+                &helper::destruct,
+                sizeof(T),
+                alignof(T),
+                std::is_trivially_copyable<T>::value,
+                &helper::equal,
+                &helper::hash,
+                &helper::append_to,
+                &typeid(T),
+                type_id<T>(),
+                unique_type_id<T>(),
+                helper::arith_index,
+                &helper::less,
+                &helper::sum,
+                &helper::difference,
+                &helper::product,
+                &helper::quotient,
+                &helper::sum_assign,
+                &helper::difference_assign,
+                &helper::product_assign,
+                &helper::quotient_assign,
+            };
+        };
+
+        template <class T, class Allocator_>
+        constexpr ObjectHelper ObjectHelperTable<T, Allocator_>::value;
+
+        template <class T, class Allocator_>
+        struct TypedArrayHelper {
+            static decltype(auto) allocator() { return AllocatorInstance<Allocator_>::get(); }
+
+            static void* get_allocator() { return &AllocatorInstance<Allocator_, false>::get(); }
 
-            void* allocate(size_t size) override { return allocator.allocate(size); }
+            static void* allocate(size_t size) { return allocator().allocate(size); }
 
-            void destroy_deallocate(void* ptr, size_t n) override {
+            static void destroy_deallocate(void* ptr, size_t n, size_t capacity) {
                 T* _ptr = static_cast<T*>(ptr);
                 internal::destroy_n(_ptr, n);
-                allocator.deallocate(_ptr, n);
+                allocator().deallocate(_ptr, capacity);
             }
 
-            void construct(void* ptr, size_t n) override {
-                T* begin = static_cast<T*>(ptr);
-                const T* end = begin + n;
-                T default_value{};
-                while (begin != end) {
-                    internal::copy_construct_at(begin, default_value);
-                    ++begin;
+            static void construct_default(void* ptr, size_t n) {
+                construct_default_n(static_cast<T*>(ptr), n, IsZeroInitializable<T>{});
+            }
+            /// \brief value initialized T is all zero bytes
+            static void construct_default_n(T* ptr, size_t n, std::true_type) {
+                if (n > 0) {
+                    std::memset(static_cast<void*>(ptr), 0, n * sizeof(T));
+                }
+            }
+            static void construct_default_n(T* ptr, size_t n, std::false_type) {
+                size_t i = 0;
+                try {
+                    for (; i < n; ++i) {
+                        ::new (ptr + i) T();
+                    }
+                } catch (...) {
+                    internal::destroy_n(ptr, i);
+                    throw;
+                }
+            }
+            /// \brief copy construct [n] elements of [src] into uninitialized [dst]
+            static void copy_n(const T* src, size_t n, T* dst, std::true_type) {
+                if (n > 0) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+                }
+            }
+            static void copy_n(const T* src, size_t n, T* dst, std::false_type) {
+                size_t i = 0;
+                try {
+                    for (; i < n; ++i) {
+                        internal::copy_construct_at(dst + i, src[i]);
+                    }
+                } catch (...) {
+                    internal::destroy_n(dst, i);
+                    throw;
                 }
             }
 
-            void construct(void* ptr, const void* value) override {
+            static void construct(void* ptr, const void* value) {
                 internal::copy_construct_at(static_cast<T*>(ptr),
                                             *static_cast<const T*>(value));
             }
 
-            void destruct(void* ptr) override {
+            static void destruct(void* ptr) {
                 internal::destroy_at(static_cast<T*>(ptr));
             }
 
-            void* make_copy(const void* src, size_t n) override {
-                void* arr = allocate(n);
-                void* dst = arr;
-                while (n--) {
-                    construct(dst, src);
-                    src = advance(src, 1);
-                    dst = advance(dst, 1);
+            static void destroy(void* ptr, size_t n) {
+                internal::destroy_n(static_cast<T*>(ptr), n);
+            }
+
+            static void* make_copy(const void* src, size_t n) {
+                return make_partial_copy(src, n, n);
+            }
+            static void* make_partial_copy(const void* src, size_t size, size_t n) {
+                T* arr = allocator().allocate(size);
+                try {
+                    copy_n(static_cast<const T*>(src), n, arr, std::is_trivially_copyable<T>{});
+                    try {
+                        construct_default(arr + n, size - n); // default value for elements beyond [n]
+                    } catch (...) {
+                        internal::destroy_n(arr, n);
+                        throw;
+                    }
+                } catch (...) {
+                    allocator().deallocate(arr, size);
+                    throw;
                 }
                 return arr;
             }
-            void* make_copy(const void* src, size_t size, size_t n) override {
-                void* arr = allocate(size);
-                void* dst = arr;
-                size -= n;
-                while (n--) {
-                    construct(dst, src);
-                    src = advance(src, 1);
-                    dst = advance(dst, 1);
+            /// \brief move [n] elements into storage of [new_capacity] and release [ptr]
+            static void* reallocate(void* ptr, size_t n, size_t capacity, size_t new_capacity) {
+                if (ptr == nullptr) {
+                    return allocate(new_capacity);
                 }
-                if (size > 0) { // construct default value for elements beyond [n]
-                    construct(dst, size);
+                return reallocate_storage(static_cast<T*>(ptr), n, capacity, new_capacity,
+                                          HasReallocate<Allocator_, T>{});
+            }
+            static void* reallocate_storage(T* ptr, size_t, size_t capacity, size_t new_capacity, std::true_type) {
+                return allocator().reallocate(ptr, capacity, new_capacity);
+            }
+            static void* reallocate_storage(T* ptr, size_t n, size_t capacity, size_t new_capacity, std::false_type) {
+                T* arr = allocator().allocate(new_capacity);
+                try {
+                    relocate_n(ptr, n, arr, std::is_trivially_copyable<T>{});
+                } catch (...) {
+                    allocator().deallocate(arr, new_capacity);
+                    throw;
                 }
+                allocator().deallocate(ptr, capacity);
                 return arr;
             }
-            ptrdiff_t distance(const void* high, const void* low) override {
+            /// \brief trivially copyable elements are relocated with a single memcpy
+            static void relocate_n(T* src, size_t n, T* dst, std::true_type) {
+                if (n > 0) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+                }
+            }
+            /// \brief elements are moved, or copied when move may throw so [src] stays intact on failure
+            static void relocate_n(T* src, size_t n, T* dst, std::false_type) {
+                size_t i = 0;
+                try {
+                    for (; i < n; ++i) {
+                        ::new (dst + i) T(std::move_if_noexcept(src[i]));
+                    }
+                } catch (...) {
+                    internal::destroy_n(dst, i);
+                    throw;
+                }
+                internal::destroy_n(src, n);
+            }
+            static ptrdiff_t distance(const void* high, const void* low) {
                 return static_cast<const T*>(high) - static_cast<const T*>(low);
             }
-            void* advance(void* ptr, size_t n) override {
-                return static_cast<void*>(static_cast<T*>(ptr) + n);
+            static void* advance(const void* ptr, size_t n) {
+                return const_cast<T*>(static_cast<const T*>(ptr) + n);
+            }
+            static bool equal(const void* lhs, const void* rhs, size_t n) {
+                return equal_range(lhs, rhs, n, HasUniqueRepresentation<T>{});
+            }
+            static bool equal_range(const void* lhs, const void* rhs, size_t n, std::true_type) {
+                return n == 0 || std::memcmp(lhs, rhs, n * sizeof(T)) == 0;
             }
-            const void* advance(const void* ptr, size_t n) override {
-                return static_cast<const void*>(static_cast<const T*>(ptr) + n);
+            static bool equal_range(const void* lhs, const void* rhs, size_t n, std::false_type) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (!EqualHelper<T>(static_cast<const T*>(lhs) + i, static_cast<const T*>(rhs) + i)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            static size_t hash(const void* ptr, size_t n) {
+                return hash_range(ptr, n, HasUniqueRepresentation<T>{});
+            }
+            static size_t hash_range(const void* ptr, size_t n, std::true_type) {
+                return hash_bytes(ptr, n * sizeof(T));
+            }
+            static size_t hash_range(const void* ptr, size_t n, std::false_type) {
+                size_t seed = n;
+                for (const T *p = static_cast<const T*>(ptr), *end = p + n; p != end; ++p) {
+                    seed = hash_combine(seed, HashHelper<T>(p));
+                }
+                return seed;
             }
-            const type_info* type() override { return &typeid(T); }
         };
 
         template <class T, class Allocator_>
-        ObjectHelper* OBJECT_HELPER = new TypedObjectHelper<T, Allocator_>();
+        struct ArrayHelperTable : TypedArrayHelper<T, Allocator_> {
+            using helper = TypedArrayHelper<T, Allocator_>;
+            static constexpr ArrayHelper value = {
+                &helper::get_allocator,
+                &helper::allocate,
+                &helper::destroy_deallocate,
+                &helper::construct_default,
+                &helper::construct,
+                &helper::destruct,
+                &helper::destroy,
+                &helper::make_copy,
+                &helper::make_partial_copy,
+                &helper::reallocate,
+                &helper::distance,
+                &helper::advance,
+                &helper::equal,
+                &helper::hash,
+                &typeid(T),
+                type_id<T>(),
+                unique_type_id<T>(),
+            };
+        };
 
         template <class T, class Allocator_>
-        ArrayHelper* ARRAY_HELPER = new TypedArrayHelper<T, Allocator_>();
+        constexpr ArrayHelper ArrayHelperTable<T, Allocator_>::value;
 
         template <class T>
         void copy_construct_at(T* p, const T& value) {
             ::new (p) T(value);
         }
 
+        template <class T>
+        void move_construct_at(T* p, T& value) {
+            ::new (p) T(std::move(value));
+        }
+
         template <class T>
         void destroy_at(T* p) {
             p->~T();
         }
 
+        template <size_t Size>
+        struct UnsignedOfSize;
+        template <>
+        struct UnsignedOfSize<1> { using type = std::uint8_t; };
+        template <>
+        struct UnsignedOfSize<2> { using type = std::uint16_t; };
+        template <>
+        struct UnsignedOfSize<4> { using type = std::uint32_t; };
+        template <>
+        struct UnsignedOfSize<8> { using type = std::uint64_t; };
+
+        /// \brief unsigned key whose order matches the order of T
         template <class T>
-        void destroy_n(T* p, size_t n) {
+        struct RadixKey {
+            using type = typename UnsignedOfSize<sizeof(T)>::type;
+            static constexpr type SIGN_BIT = static_cast<type>(type(1) << (sizeof(T) * 8 - 1));
+
+            static type encode(T value) noexcept {
+                type key;
+                std::memcpy(&key, &value, sizeof(T));
+                return encode(key, std::is_floating_point<T>{});
+            }
+            /// \brief negative floats have all bits flipped so larger magnitudes sort first
+            static type encode(type key, std::true_type) noexcept {
+                return (key & SIGN_BIT) ? static_cast<type>(~key) : static_cast<type>(key | SIGN_BIT);
+            }
+            static type encode(type key, std::false_type) noexcept {
+                return std::is_signed<T>::value ? static_cast<type>(key ^ SIGN_BIT) : key;
+            }
+        };
+
+        template <class T>
+        void radix_sort(T* data, size_t n, std::false_type) {
+            std::sort(data, data + n);
+        }
+
+        /// \brief stable LSD radix sort on bytes of the key, passes where all keys share a byte are skipped
+        template <class T>
+        void radix_sort(T* data, size_t n, std::true_type) {
+            constexpr size_t RADIX = 256, SMALL_SIZE = 256;
+            if (n < SMALL_SIZE) {
+                std::stable_sort(data, data + n);
+                return;
+            }
+            using Key = RadixKey<T>;
+            size_t counts[sizeof(T)][RADIX] = {};
+            for (size_t i = 0; i < n; ++i) {
+                typename Key::type key = Key::encode(data[i]);
+                for (size_t pass = 0; pass < sizeof(T); ++pass) {
+                    ++counts[pass][(key >> (pass * 8)) & (RADIX - 1)];
+                }
+            }
+            std::unique_ptr<T[]> buffer(new T[n]);
+            T* src = data;
+            T* dst = buffer.get();
+            for (size_t pass = 0; pass < sizeof(T); ++pass) {
+                size_t* count = counts[pass];
+                if (count[(Key::encode(src[0]) >> (pass * 8)) & (RADIX - 1)] == n) {
+                    continue;
+                }
+                size_t offset = 0;
+                for (size_t digit = 0; digit < RADIX; ++digit) {
+                    size_t c = count[digit];
+                    count[digit] = offset;
+                    offset += c;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    dst[count[(Key::encode(src[i]) >> (pass * 8)) & (RADIX - 1)]++] = src[i];
+                }
+                std::swap(src, dst);
+            }
+            if (src != data) {
+                std::memcpy(data, src, n * sizeof(T));
+            }
+        }
+
+        template <class T>
+        void radix_sort(T* data, size_t n) {
+            radix_sort(data, n, IsRadixSortable<T>{});
+        }
+
+        template <class T>
+        void stable_sort(T* data, size_t n) {
+            if (IsRadixSortable<T>::value)
+                radix_sort(data, n, IsRadixSortable<T>{});
+            else
+                std::stable_sort(data, data + n);
+        }
+
+        /// \brief branch-free compaction, every element is stored and [out] only advances on a match
+        template <class T, class Pred>
+        T* compact_if(T* first, T* last, T* out, Pred& keep, std::true_type) {
+            for (; first != last; ++first) {
+                T value = *first;
+                *out = value;
+                out += static_cast<bool>(keep(value));
+            }
+            return out;
+        }
+
+        /// \brief move kept elements forward, skipping self-moves
+        template <class T, class Pred>
+        T* compact_if(T* first, T* last, T* out, Pred& keep, std::false_type) {
+            for (; first != last; ++first) {
+                if (keep(static_cast<const T&>(*first))) {
+                    if (out != first) {
+                        *out = std::move(*first);
+                    }
+                    ++out;
+                }
+            }
+            return out;
+        }
+
+        /// \brief move elements of [first, last) satisfying [keep] to the front of [out],
+        ///        which is [first] or a position before it. Returns end of kept elements.
+        template <class T, class Pred>
+        T* compact_if(T* first, T* last, T* out, Pred& keep) {
+            return compact_if(first, last, out, keep, std::is_arithmetic<T>{});
+        }
+
+        /// \brief store the result of [keep] for each of the [n] elements into [marks],
+        ///        returns the number of marked elements
+        template <class T, class Pred>
+        size_t mark_if(const T* first, size_t n, bool* marks, Pred& keep) {
+            size_t kept = 0;
+            for (size_t i = 0; i < n; ++i) {
+                marks[i] = static_cast<bool>(keep(first[i]));
+                kept += marks[i];
+            }
+            return kept;
+        }
+
+        /// \brief copy marked elements of [first, first+n) into uninitialized [out],
+        ///        returns end of copied elements
+        template <class T>
+        T* copy_marked(const T* first, size_t n, const bool* marks, T* out) {
+            T* begin = out;
+            try {
+                for (size_t i = 0; i < n; ++i) {
+                    if (marks[i]) {
+                        internal::copy_construct_at(out, first[i]);
+                        ++out;
+                    }
+                }
+            } catch (...) {
+                internal::destroy_n(begin, out - begin);
+                throw;
+            }
+            return out;
+        }
+
+        template <class T>
+        void destroy_n(T* p, size_t n, std::false_type) {
             for (const T* end = p + n; p != end; ++p)
                 internal::destroy_at(p);
         }
 
+        template <class T>
+        void destroy_n(T*, size_t, std::true_type) {
+        }
+
+        /// \brief destroy [n] elements from [p], no-op for trivially destructible T
+        template <class T>
+        void destroy_n(T* p, size_t n) {
+            destroy_n(p, n, std::is_trivially_destructible<T>{});
+        }
+
+        template <class T, class Value>
+        void assign_value(void* dst, Value&& value, std::true_type) {
+            *static_cast<T*>(dst) = std::forward<Value>(value);
+        }
+
+        template <class T, class Value>
+        void assign_value(void*, Value&&, std::false_type) {
+        }
+
         template <class Iterator>
         void move(Iterator src, Iterator dst) {
             using T = std::decay_t<decltype(*src)>;
@@ -814,19 +4828,44 @@ namespace typeless {
         }
 
         template <class T, class Allocator_>
-        ObjectHelper* GetObjectHelper() {
-            return OBJECT_HELPER<T, Allocator_>;
+        const ObjectHelper* GetObjectHelper() noexcept {
+            return &ObjectHelperTable<T, Allocator_>::value;
         }
         template <class T, class Allocator_>
-        ArrayHelper* GetArrayHelper() {
-            return ARRAY_HELPER<T, Allocator_>;
+        const ArrayHelper* GetArrayHelper() noexcept {
+            return &ArrayHelperTable<T, Allocator_>::value;
         }
     } // namespace internal
 #pragma endregion InternalImpl
 } // namespace typeless
 
+namespace std {
+    /// \brief values of a type without std::hash all hash alike,
+    ///        specialize std::hash for types used as keys
+    template <>
+    struct hash<typeless::Object> {
+        size_t operator()(const typeless::Object& obj) const { return obj.hash(); }
+    };
+
+    template <>
+    struct hash<typeless::Array> {
+        size_t operator()(const typeless::Array& arr) const { return arr.hash(); }
+    };
+} // namespace std
+
 static std::ostream& operator<<(std::ostream& os, const typeless::Object& obj) {
-    return os << obj.to_string();
+    thread_local std::string buffer; // reused, so printing does not allocate once warmed up
+    buffer.clear();
+    obj.append_to(buffer);
+    return os.write(buffer.data(), buffer.size());
+}
+
+// inline rather than static, so translation units that do not print a SharedObject get no unused-function warning
+inline std::ostream& operator<<(std::ostream& os, const typeless::SharedObject& obj) {
+    thread_local std::string buffer;
+    buffer.clear();
+    obj.object().append_to(buffer);
+    return os.write(buffer.data(), buffer.size());
 }
 
 static std::ostream& operator<<(std::ostream& os, const std::type_info& info) {
@@ -834,5 +4873,4 @@ static std::ostream& operator<<(std::ostream& os, const std::type_info& info) {
 }
 #endif
 // TODO: add operator+ for generic types
-// TODO: add push_back, erase
-// TODO: add TypedArray conversion
\ No newline at end of file
+// TODO: add erase
\ No newline at end of file
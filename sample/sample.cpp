@@ -9,7 +9,7 @@ void CharArrayToString() {
 
 void SumOfEvenNumbers() {
     auto arr = Array{1,2,3,4,5,6,7,8,9};
-    auto sum = arr.filter<int>([](int i) { return i % 2 == 0; }).join<int>(); // 20
+    auto sum = arr.filter<int>([](int i) { return i % 2 == 0; }).sum<int>(); // 20
     std::cout << sum << std::endl;
 }
 
@@ -19,8 +19,16 @@ void Print(const Array& args) { // print arguments with different types
     });
 }
 
+void PrintPacked(const VariantArray& args) { // same, values packed in one buffer
+    args.visit([] (VariantRef arg) {
+        std::cout << arg.to_string();
+    });
+}
+
 int main() {
     CharArrayToString();
     SumOfEvenNumbers();
     Print(ObjectArray{123, '+', 456, string(" = "), 123+456});
+    std::cout << std::endl;
+    PrintPacked(VariantArray{123, '+', 456, string(" = "), 123+456});
 }
\ No newline at end of file
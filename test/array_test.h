@@ -1,8 +1,11 @@
 #ifndef ARRAY_TEST_H
 #define ARRAY_TEST_H
+#include <cmath>
 #include <gtest/gtest.h>
 #include <numeric>
+#include <random>
 #include <typeless.h>
+#include <unordered_map>
 
 
 using namespace typeless;
@@ -73,6 +76,43 @@ TEST(ArrayTest, Type) {
     EXPECT_EQ(char_arr.type(), typeid(char));
 }
 
+TEST(ArrayTest, HasType) {
+    Array int_arr{1, 2, 3};
+    Array str_arr = StringArray{"foo"};
+    EXPECT_TRUE(int_arr.has_type<int>());
+    EXPECT_FALSE(int_arr.has_type<string>());
+    EXPECT_TRUE(str_arr.has_type<string>());
+    EXPECT_TRUE(Array().has_type<std::nullptr_t>());
+}
+
+TEST(ArrayTest, Equality) {
+    EXPECT_EQ(Array({1, 2, 3}), Array({1, 2, 3}));
+    EXPECT_NE(Array({1, 2, 3}), Array({1, 2, 4}));
+    EXPECT_NE(Array({1, 2, 3}), Array({1, 2}));
+    EXPECT_NE(Array({1, 2, 3}), Array({1L, 2L, 3L}));
+    EXPECT_EQ(Array(StringArray{"foo", "bar"}), Array(StringArray{"foo", "bar"}));
+    EXPECT_NE(Array(StringArray{"foo", "bar"}), Array(StringArray{"foo", "baz"}));
+    EXPECT_EQ(Array(), Array());
+}
+
+TEST(ArrayTest, Hash) {
+    std::hash<Array> hasher;
+    std::vector<int> large(1000);
+    std::iota(large.begin(), large.end(), 0);
+    Array a(large.begin(), large.end()), b(large.begin(), large.end());
+    EXPECT_EQ(hasher(a), hasher(b));
+    b.at<int>(999) = 0;
+    EXPECT_NE(hasher(a), hasher(b));
+    EXPECT_EQ(hasher(Array(StringArray{"foo", "bar"})), hasher(Array(StringArray{"foo", "bar"})));
+    EXPECT_NE(hasher(Array({1, 2})), hasher(Array({2, 1})));
+    std::unordered_map<Array, int> map;
+    map[Array{1, 2, 3}] = 1;
+    map[Array(StringArray{"foo"})] = 2;
+    map[Array{1, 2, 3}] += 10;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map[Array({1, 2, 3})], 11);
+}
+
 TEST(ArrayTest, Join) {
     Array a1{'f', 'o', 'o', ' ', 'b', 'a', 'r'};
     Array a2 = StringArray{"foo", " ", "bar"};
@@ -81,6 +121,50 @@ TEST(ArrayTest, Join) {
     EXPECT_EQ(a2.join<string>(), joined);
 }
 
+TEST(ArrayTest, JoinCallable) {
+    const Array arr{1, 2, 3, 4};
+    int calls = 0;
+    auto sum = arr.join<int, long long>([&calls](int v, long long& r) {
+        ++calls;
+        r += v;
+    });
+    EXPECT_EQ(sum, 10);
+    EXPECT_EQ(calls, 4);
+    EXPECT_EQ(arr.join<int>(), 10);
+}
+
+TEST(ArrayTest, Reduce) {
+    const Array arr{1, 2, 3, 4};
+    int factor = 10;
+    EXPECT_EQ(arr.reduce<int>(0, [factor](int acc, int v) { return acc + v * factor; }), 100);
+    auto append_int = [](string acc, int v) {
+        acc += std::to_string(v);
+        return acc;
+    };
+    EXPECT_EQ(arr.reduce<int>(string(), append_int), "1234");
+    auto append = [](string acc, const string& s) {
+        acc += s;
+        return acc;
+    };
+    Array str_arr = StringArray{"foo", " ", "bar"};
+    EXPECT_EQ(str_arr.reduce<string>(string(">"), append), ">foo bar");
+    EXPECT_EQ(Array().reduce<int>(7, std::plus<int>()), 7);
+}
+
+TEST(ArrayTest, Map) {
+    const Array arr{1, 2, 3};
+    Array halves = arr.map<int>([](int i) { return i / 2.0; });
+    EXPECT_TRUE(halves.has_type<double>());
+    EXPECT_EQ(halves, Array({0.5, 1.0, 1.5}));
+    Array strs = arr.map<int, string>([](int i) { return string(i, '*'); });
+    EXPECT_EQ(strs, Array(StringArray{"*", "**", "***"}));
+    Array lengths = strs.map<string>([](const string& s) { return s.size(); });
+    EXPECT_EQ(lengths.sum<size_t>(), 6);
+    Array empty_mapped = Array(ArrayInit<int>{}).map<int, float>([](int i) { return i * 1.0f; });
+    EXPECT_TRUE(empty_mapped.empty());
+    EXPECT_TRUE(empty_mapped.has_type<float>());
+}
+
 TEST(ArrayTest, Swap) {
     Array str_arr = StringArray{"foo", "bar"};
     Array int_arr{1, 2, 3};
@@ -111,6 +195,49 @@ TEST(ArrayTest, Filter) {
     auto arr = Array{1, 2, 3, 4, 5, 6, 7, 8, 9};
     auto sum = arr.filter<int>([](int i) { return i % 3 == 0; }).join<int>();
     EXPECT_EQ(sum, 18);
+    EXPECT_EQ(arr.filter<int>([](int i) { return i % 3 == 0; }), Array({3, 6, 9}));
+    Array str_arr = StringArray{"foo", "bar", "baz"};
+    Array filtered = str_arr.filter<string>([](const string& s) { return s[0] == 'b'; });
+    EXPECT_EQ(filtered, Array(StringArray{"bar", "baz"}));
+    EXPECT_EQ(filtered.capacity(), 2);
+    EXPECT_EQ(str_arr.size(), 3);
+    EXPECT_EQ(arr.filter<int>([](int i) { return i == 5; }).capacity(), 1);
+    EXPECT_EQ(arr.filter<int>([](int) { return false; }).capacity(), 0);
+    int calls = 0;
+    EXPECT_EQ(str_arr.filter<string>([&calls](const string&) { return ++calls % 2 == 0; }), Array(StringArray{"bar"}));
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(ArrayTest, EraseIf) {
+    Array arr{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const void* data = arr.data<int>();
+    EXPECT_EQ(arr.erase_if<int>([](int i) { return i % 2 == 0; }), 4);
+    EXPECT_EQ(arr, Array({1, 3, 5, 7, 9}));
+    EXPECT_EQ(arr.retain<int>([](int i) { return i > 3; }), 2);
+    EXPECT_EQ(arr, Array({5, 7, 9}));
+    EXPECT_EQ(arr.data<int>(), data); // compacted in place
+    Array str_arr = StringArray{"foo", "bar", string(100, 'x'), "baz"};
+    EXPECT_EQ(str_arr.erase_if<string>([](const string& s) { return s == "bar"; }), 1);
+    EXPECT_EQ(str_arr, Array(StringArray{"foo", string(100, 'x'), "baz"}));
+    EXPECT_EQ(str_arr.retain<string>([](const string& s) { return s.empty(); }), 3);
+    EXPECT_TRUE(str_arr.empty());
+}
+
+TEST(ArrayTest, Size) {
+    Array untyped;
+    EXPECT_EQ(untyped.size(), 0);
+    EXPECT_TRUE(untyped.empty());
+    Array strs = StringArray{"a", "b", "c"};
+    Array copy = strs;
+    Array moved = std::move(copy);
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_EQ(copy.size(), 0);
+    Array filtered = moved.filter<string>([](const string& s) { return s != "b"; });
+    EXPECT_EQ(filtered.size(), 2);
+    untyped = filtered;
+    EXPECT_EQ(untyped.size(), 2);
+    untyped.push_back(string("d"));
+    EXPECT_EQ(untyped.size(), 3);
 }
 
 TEST(ArrayTest, ResizeGrow) {
@@ -134,6 +261,212 @@ TEST(ArrayTest, ResizeShrink) {
     EXPECT_EQ(arr.join<string>(), "Hello ");
 }
 
+TEST(ArrayTest, PushBack) {
+    Array arr;
+    for (int i = 0; i < 100; ++i) {
+        arr.push_back(i);
+    }
+    EXPECT_TRUE(arr.has_type<int>());
+    EXPECT_EQ(arr.size(), 100);
+    EXPECT_GE(arr.capacity(), 100);
+    EXPECT_EQ(arr.join<int>(), 4950);
+    Array str_arr = StringArray{"foo"};
+    for (int i = 0; i < 10; ++i) {
+        str_arr.push_back(str_arr.at<string>(0)); // element of itself, across reallocation
+    }
+    EXPECT_EQ(str_arr.size(), 11);
+    EXPECT_EQ(str_arr.at<string>(10), "foo");
+    EXPECT_EQ(str_arr.emplace_back<string>(3, 'x'), "xxx");
+    EXPECT_EQ(str_arr.at<string>(11), "xxx");
+}
+
+TEST(ArrayTest, Reserve) {
+    Array arr{1, 2, 3};
+    EXPECT_EQ(arr.capacity(), 3);
+    arr.reserve(64);
+    EXPECT_EQ(arr.capacity(), 64);
+    EXPECT_EQ(arr.size(), 3);
+    const void* data = arr.data<int>();
+    for (int i = 0; i < 61; ++i) {
+        arr.push_back(i);
+    }
+    EXPECT_EQ(arr.data<int>(), data); // no reallocation within capacity
+    arr.resize(10);
+    EXPECT_EQ(arr.capacity(), 64);
+    arr.shrink_to_fit();
+    EXPECT_EQ(arr.capacity(), 10);
+    EXPECT_EQ(arr.join<int>(), 6 + 21);
+    arr.resize(0);
+    EXPECT_TRUE(arr.empty());
+    arr.shrink_to_fit();
+    EXPECT_EQ(arr.capacity(), 0);
+    EXPECT_TRUE(arr.has_type<int>());
+}
+
+struct MoveCounter {
+    static int copies;
+    static int moves;
+    MoveCounter() = default;
+    MoveCounter(const MoveCounter&) { ++copies; }
+    MoveCounter(MoveCounter&&) noexcept { ++moves; }
+};
+int MoveCounter::copies = 0;
+int MoveCounter::moves = 0;
+
+TEST(ArrayTest, ReallocationMoves) {
+    MoveCounter::copies = MoveCounter::moves = 0;
+    Array arr;
+    arr.set_type<MoveCounter>();
+    arr.resize(4);
+    arr.resize(100);
+    EXPECT_EQ(MoveCounter::moves, 4);
+    arr.shrink_to_fit();
+    arr.emplace_back<MoveCounter>();
+    EXPECT_EQ(MoveCounter::copies, 0); // elements are never copied on default construction or reallocation
+    Array str_arr = StringArray{string(100, 'a'), string(100, 'b')};
+    const char* heap_data = str_arr.at<string>(0).data();
+    str_arr.reserve(100);
+    EXPECT_EQ(str_arr.at<string>(0).data(), heap_data); // buffer moved, not copied
+}
+
+TEST(ArrayTest, Reductions) {
+    std::vector<int> v(1003);
+    std::iota(v.begin(), v.end(), -500);
+    Array arr(v.begin(), v.end());
+    EXPECT_EQ(arr.sum<int>(), std::accumulate(v.begin(), v.end(), 0LL));
+    EXPECT_EQ(arr.min<int>(), -500);
+    EXPECT_EQ(arr.max<int>(), 502);
+    EXPECT_EQ(arr.minmax<int>(), std::make_pair(-500, 502));
+    EXPECT_DOUBLE_EQ(arr.mean<int>(), 1.0);
+    EXPECT_EQ(arr.dot<int>(arr), std::inner_product(v.begin(), v.end(), v.begin(), 0LL));
+    Array large{INT32_MAX, INT32_MAX, INT32_MAX};
+    EXPECT_EQ(large.sum<int>(), 3LL * INT32_MAX); // summed as 64-bit
+    Array doubles{0.5, -1.5, 4.0, 2.0};
+    EXPECT_EQ(doubles.sum<double>(), 5.0);
+    EXPECT_EQ(doubles.minmax<double>(), std::make_pair(-1.5, 4.0));
+    EXPECT_EQ(doubles.dot<double>(doubles), 22.5);
+    Array shorts{short(3), short(-7), short(2)};
+    EXPECT_EQ(shorts.sum<short>(), -2);
+    EXPECT_EQ(shorts.min<short>(), -7);
+    Array empty;
+    empty.set_type<float>();
+    EXPECT_EQ(empty.sum<float>(), 0.0f);
+    EXPECT_TRUE(std::isnan(empty.mean<float>()));
+}
+
+TEST(ArrayTest, Sort) {
+    std::mt19937_64 rng(42);
+    std::vector<int> ints(5000);
+    for (int& v : ints)
+        v = static_cast<int>(rng());
+    Array int_arr(ints.begin(), ints.end());
+    int_arr.sort<int>();
+    std::sort(ints.begin(), ints.end());
+    EXPECT_EQ(int_arr, Array(ints.begin(), ints.end()));
+    std::vector<double> doubles(5000);
+    for (double& v : doubles)
+        v = std::uniform_real_distribution<double>(-1e6, 1e6)(rng);
+    doubles[0] = -std::numeric_limits<double>::infinity();
+    doubles[1] = std::numeric_limits<double>::infinity();
+    Array double_arr(doubles.begin(), doubles.end());
+    double_arr.sort<double>();
+    std::sort(doubles.begin(), doubles.end());
+    EXPECT_EQ(double_arr, Array(doubles.begin(), doubles.end()));
+    std::vector<std::uint64_t> keys(1000, 0xFF00); // only some bytes differ, the others are skipped
+    for (std::uint64_t& v : keys)
+        v |= rng() & 0xFF;
+    Array key_arr(keys.begin(), keys.end());
+    key_arr.sort<std::uint64_t>();
+    std::sort(keys.begin(), keys.end());
+    EXPECT_EQ(key_arr, Array(keys.begin(), keys.end()));
+    Array small{3.5f, -1.0f, 2.0f};
+    small.sort<float>();
+    EXPECT_EQ(small, (Array{-1.0f, 2.0f, 3.5f}));
+    Array strs = StringArray{"pear", "apple", "fig"};
+    strs.sort<string>();
+    EXPECT_EQ(strs, Array(StringArray{"apple", "fig", "pear"}));
+    strs.sort<string>(std::greater<string>());
+    EXPECT_EQ(strs, Array(StringArray{"pear", "fig", "apple"}));
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__) // integral, but wider than any radix key
+    Array wide{static_cast<__int128>(3), static_cast<__int128>(-1) << 100, static_cast<__int128>(2)};
+    wide.sort<__int128>();
+    EXPECT_EQ(wide, (Array{static_cast<__int128>(-1) << 100, static_cast<__int128>(2), static_cast<__int128>(3)}));
+    Array wide_unsigned{static_cast<unsigned __int128>(1) << 100, static_cast<unsigned __int128>(1)};
+    wide_unsigned.stable_sort<unsigned __int128>();
+    EXPECT_EQ(wide_unsigned, (Array{static_cast<unsigned __int128>(1), static_cast<unsigned __int128>(1) << 100}));
+#endif
+}
+
+TEST(ArrayTest, StableSort) {
+    using Entry = std::pair<int, int>;
+    Array entries{Entry{2, 0}, Entry{1, 1}, Entry{2, 2}, Entry{1, 3}};
+    entries.stable_sort<Entry>([](const Entry& l, const Entry& r) { return l.first < r.first; });
+    EXPECT_EQ(entries, (Array{Entry{1, 1}, Entry{1, 3}, Entry{2, 0}, Entry{2, 2}}));
+    std::vector<long long> values(1000);
+    std::iota(values.rbegin(), values.rend(), -500LL);
+    Array arr(values.begin(), values.end());
+    arr.stable_sort<long long>();
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(arr, Array(values.begin(), values.end()));
+}
+
+TEST(ArrayTest, PartialSortAndSearch) {
+    Array arr{9, 4, 7, 1, 8, 2};
+    arr.partial_sort<int>(3);
+    EXPECT_EQ(arr.at<int>(0), 1);
+    EXPECT_EQ(arr.at<int>(1), 2);
+    EXPECT_EQ(arr.at<int>(2), 4);
+    arr.nth_element<int>(4);
+    EXPECT_EQ(arr.at<int>(4), 8);
+    arr.nth_element<int>(0, std::greater<int>());
+    EXPECT_EQ(arr.at<int>(0), 9);
+    Array sorted{1, 3, 3, 3, 5};
+    EXPECT_EQ(sorted.lower_bound(3), 1u);
+    EXPECT_EQ(sorted.upper_bound(3), 4u);
+    EXPECT_EQ(sorted.lower_bound(6), 5u);
+    EXPECT_TRUE(sorted.binary_search(5));
+    EXPECT_FALSE(sorted.binary_search(4));
+}
+
+TEST(ArrayTest, CopyOnWrite) {
+    Array arr = StringArray{"foo", "bar", "baz"};
+    EXPECT_FALSE(arr.copy_on_write());
+    arr.set_copy_on_write(true);
+    const Array& const_arr = arr;
+    const string* shared = const_arr.data<string>();
+    Array copy = arr;
+    EXPECT_TRUE(copy.copy_on_write());
+    EXPECT_EQ(arr.use_count(), 2);
+    const Array& const_copy = copy;
+    EXPECT_EQ(const_copy.data<string>(), shared); // O(1), no element copied
+    EXPECT_EQ(copy.at<string>(1), "bar");     // the non-const at<T> detaches
+    EXPECT_NE(const_copy.data<string>(), shared);
+    EXPECT_EQ(arr.use_count(), 1);
+    copy.set(0, string("qux"));
+    EXPECT_EQ(const_arr.at<string>(0), "foo");
+    Array assigned;
+    assigned = arr;
+    assigned.resize(1);
+    EXPECT_EQ(arr.size(), 3);
+    EXPECT_EQ(assigned, Array(StringArray{"foo"}));
+    Array moved = std::move(assigned);
+    EXPECT_TRUE(moved.copy_on_write());
+    arr.reserve(10);
+    Array grown = arr;
+    grown.reserve(20); // copies the shared elements before growing
+    EXPECT_GE(grown.capacity(), 20);
+    EXPECT_EQ(grown, arr);
+    Array shrunk = arr;
+    shrunk.shrink_to_fit();
+    EXPECT_EQ(shrunk.capacity(), 3);
+    EXPECT_GE(arr.capacity(), 10);
+    EXPECT_EQ(arr.use_count(), 1);
+    Array deep = Array{1, 2};
+    Array deep_copy = deep;
+    EXPECT_EQ(deep.use_count(), 1);
+    EXPECT_NE(static_cast<const Array&>(deep_copy).data<int>(), static_cast<const Array&>(deep).data<int>());
+}
+
 int tester_constructor_called = 0;
 int tester_destructor_called = 0;
 
@@ -0,0 +1,109 @@
+#ifndef ARRAY_VIEW_TEST_H
+#define ARRAY_VIEW_TEST_H
+#include <gtest/gtest.h>
+#include <numeric>
+#include <typeless.h>
+#include <vector>
+
+using namespace typeless;
+
+TEST(ArrayViewTest, Slice) {
+    const Array arr{1, 2, 3, 4, 5, 6};
+    ArrayView view = arr.slice(1, 4);
+    EXPECT_EQ(view.size(), 4);
+    EXPECT_TRUE(view.has_type<int>());
+    EXPECT_EQ(view.data<int>(), arr.data<int>() + 1); // no copy
+    EXPECT_EQ(view.at<int>(0), 2);
+    EXPECT_EQ(view.use_count(), 2);
+    ArrayView inner = view.slice(2, 2);
+    EXPECT_EQ(inner.at<int>(1), 5);
+    EXPECT_EQ(inner.use_count(), 3);
+    EXPECT_TRUE(arr.slice(6, 0).empty());
+    EXPECT_TRUE(ArrayView().empty());
+    EXPECT_TRUE(Array().slice(0, 0).empty());
+}
+
+TEST(ArrayViewTest, Algorithms) {
+    Array arr{1, 2, 3, 4, 5, 6};
+    ArrayView view = arr.slice(2, 3);
+    int total = 0;
+    view.for_each<int>([&](int v) { total += v; });
+    EXPECT_EQ(total, 12);
+    EXPECT_EQ(view.join<int>(), 12);
+    EXPECT_EQ((view.join<int, int>([](int v, int& acc) { acc = acc * 10 + v; })), 345);
+    EXPECT_EQ(view.reduce<int>(1, [](int acc, int v) { return acc * v; }), 60);
+    EXPECT_EQ(view.filter<int>([](int v) { return v % 2 == 0; }), (Array{4}));
+    EXPECT_EQ(view.filter<int>([](int v) { return v % 2 == 0; }).capacity(), 1);
+    EXPECT_EQ(view.to_array(), (Array{3, 4, 5}));
+    ArraySpan<const int> span = view.span<int>();
+    EXPECT_EQ(std::accumulate(span.begin(), span.end(), 0), 12);
+}
+
+TEST(ArrayViewTest, KeepsBufferAlive) {
+    ArrayView view;
+    {
+        Array strs = StringArray{"foo", "bar", "baz"};
+        view = strs.slice(1, 2);
+    }
+    EXPECT_EQ(view.use_count(), 1);
+    EXPECT_EQ(view.at<string>(0), "bar");
+    EXPECT_EQ(view.at<string>(1), "baz");
+}
+
+TEST(ArrayViewTest, ArrayChangesAfterSlice) {
+    Array arr{1, 2, 3};
+    const Array& const_arr = arr;
+    const int* shared = const_arr.data<int>();
+    ArrayView view = arr.slice(0, 3);
+    arr.at<int>(0) = 10; // elements are copied before the first change
+    EXPECT_NE(const_arr.data<int>(), shared);
+    EXPECT_EQ(view.at<int>(0), 1);
+    EXPECT_EQ(view.use_count(), 1);
+    arr.push_back(4);
+    arr.sort<int>();
+    EXPECT_EQ(arr, (Array{2, 3, 4, 10}));
+    EXPECT_EQ(view.to_array(), (Array{1, 2, 3}));
+    Array unique{1, 2, 3};
+    const int* owned = unique.data<int>();
+    unique.slice(0, 1); // view destroyed right away
+    unique.at<int>(0) = 5;
+    EXPECT_EQ(unique.data<int>(), owned); // buffer is taken back without copying
+}
+
+TEST(ArrayViewTest, ReserveAfterSlice) {
+    Array arr{1, 2, 3};
+    arr.reserve(100);
+    ArrayView view = arr.slice(0, 1);
+    arr.reserve(200); // copy made by unshare() is exactly sized, not 100
+    EXPECT_GE(arr.capacity(), 200u);
+    EXPECT_EQ(arr, (Array{1, 2, 3}));
+    EXPECT_EQ(view.to_array(), Array{1});
+    Array strs = StringArray{"foo", "bar"};
+    strs.reserve(10);
+    view = strs.slice(1, 1);
+    strs.reserve(5); // still has to copy even though no growth is needed
+    strs.at<string>(1) = "qux";
+    EXPECT_EQ(view.at<string>(0), "bar");
+}
+
+TEST(ArrayViewTest, WorkerBatches) {
+    std::vector<long long> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+    Array arr(values.begin(), values.end());
+    ThreadPool pool(4);
+    constexpr size_t N_BATCHES = 8;
+    size_t batch = values.size() / N_BATCHES;
+    std::vector<ArrayView> batches;
+    for (size_t i = 0; i < N_BATCHES; ++i) {
+        batches.push_back(arr.slice(i * batch, batch));
+    }
+    arr = Array(); // batches keep the buffer alive
+    std::vector<long long> sums(N_BATCHES);
+    pool.parallel_for(N_BATCHES, [&](size_t i) {
+        ArrayView local = batches[i];
+        sums[i] = local.reduce<long long>(0LL, [](long long acc, long long v) { return acc + v; });
+    });
+    EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), 0LL),
+              std::accumulate(values.begin(), values.end(), 0LL));
+}
+#endif
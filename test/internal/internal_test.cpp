@@ -1,6 +1,7 @@
 #ifndef INTERNAL_TEST_H
 #define INTERNAL_TEST_H
 #include <gtest/gtest.h>
+#include <numeric>
 
 template <typename T>
 class TestAllocator {
@@ -26,9 +27,13 @@ public:
 using namespace typeless;
 using namespace typeless::internal;
 
+struct LargeValue {
+    int values[16];
+};
+
 TEST(ObjectHelper, AllocDealloc) {
-    ObjectHelper* helper = GetObjectHelper<int>();
-    TestAllocator<int>* allocator = static_cast<TestAllocator<int>*>(helper->get_allocator());
+    const ObjectHelper* helper = GetObjectHelper<LargeValue>();
+    TestAllocator<LargeValue>* allocator = static_cast<TestAllocator<LargeValue>*>(helper->get_allocator());
     void* ptr = helper->allocate();
     EXPECT_EQ(allocator->size_allocated, 1);
     helper->destroy_deallocate(ptr);
@@ -37,19 +42,81 @@ TEST(ObjectHelper, AllocDealloc) {
 }
 
 TEST(ObjectHelper, MakeCopy) {
-    ObjectHelper* helper = GetObjectHelper<int>();
+    const ObjectHelper* helper = GetObjectHelper<int>();
     TestAllocator<int>* allocator = static_cast<TestAllocator<int>*>(helper->get_allocator());
+    InlineStorage storage;
     int i = 12345;
-    void* ptr = helper->make_copy(&i);
-    EXPECT_EQ(allocator->size_allocated, 1);
+    void* ptr = helper->make_copy(&storage, &i);
+    EXPECT_EQ(allocator->size_allocated, 0); // small value is stored inline
+    EXPECT_EQ(ptr, &storage);
     EXPECT_EQ(*static_cast<int*>(ptr), i);
     helper->destroy_deallocate(ptr);
     EXPECT_EQ(allocator->size_allocated, 0);
     allocator->reset();
 }
 
+TEST(ObjectHelper, MakeCopyLarge) {
+    const ObjectHelper* helper = GetObjectHelper<LargeValue>();
+    TestAllocator<LargeValue>* allocator = static_cast<TestAllocator<LargeValue>*>(helper->get_allocator());
+    InlineStorage storage;
+    LargeValue v{{1, 2, 3}};
+    void* ptr = helper->make_copy(&storage, &v);
+    EXPECT_EQ(allocator->size_allocated, 1);
+    EXPECT_NE(ptr, &storage);
+    EXPECT_EQ(static_cast<LargeValue*>(ptr)->values[2], 3);
+    helper->destroy_deallocate(ptr);
+    EXPECT_EQ(allocator->size_allocated, 0);
+    allocator->reset();
+}
+
+TEST(ObjectHelper, MakeMove) {
+    const ObjectHelper* helper = GetObjectHelper<LargeValue>();
+    TestAllocator<LargeValue>* allocator = static_cast<TestAllocator<LargeValue>*>(helper->get_allocator());
+    InlineStorage storage;
+    LargeValue v{{4, 5, 6}};
+    void* ptr = helper->make_move(&storage, &v);
+    EXPECT_EQ(allocator->size_allocated, 1);
+    EXPECT_EQ(static_cast<LargeValue*>(ptr)->values[1], 5);
+    helper->destroy_deallocate(ptr);
+    EXPECT_EQ(allocator->size_allocated, 0);
+    allocator->reset();
+}
+
+TEST(ObjectHelper, SetReusesStorage) {
+    TestAllocator<LargeValue>* allocator = static_cast<TestAllocator<LargeValue>*>(GetObjectHelper<LargeValue>()->get_allocator());
+    {
+        Object obj(LargeValue{{1}});
+        EXPECT_EQ(allocator->size_allocated, 1);
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_TRUE(obj.set(LargeValue{{i}}));
+        }
+        EXPECT_EQ(allocator->size_allocated, 1);
+        EXPECT_EQ(obj.get<LargeValue>().values[0], 9);
+    }
+    EXPECT_EQ(allocator->size_allocated, 0);
+    allocator->reset();
+}
+
+TEST(ObjectHelper, InlineStorage) {
+    TestAllocator<int>* int_allocator = static_cast<TestAllocator<int>*>(GetObjectHelper<int>()->get_allocator());
+    TestAllocator<double>* double_allocator = static_cast<TestAllocator<double>*>(GetObjectHelper<double>()->get_allocator());
+    TestAllocator<char>* char_allocator = static_cast<TestAllocator<char>*>(GetObjectHelper<char>()->get_allocator());
+    {
+        Object i = 123, d = 1.5, c = 'c';
+        Object copy(i), moved(std::move(d));
+        copy = c;
+        EXPECT_EQ(copy, 'c');
+        EXPECT_EQ(moved, 1.5);
+        EXPECT_TRUE(i.is_inline());
+        EXPECT_TRUE(moved.is_inline());
+    }
+    EXPECT_EQ(int_allocator->size_allocated, 0);
+    EXPECT_EQ(double_allocator->size_allocated, 0);
+    EXPECT_EQ(char_allocator->size_allocated, 0);
+}
+
 TEST(ObjectHelper, Equal) {
-    ObjectHelper* helper = GetObjectHelper<int>();
+    const ObjectHelper* helper = GetObjectHelper<int>();
     int a = 123, b = 123, c = 456;
     EXPECT_TRUE(helper->equal(&a, &b));
     EXPECT_FALSE(helper->equal(&a, &c));
@@ -57,18 +124,20 @@ TEST(ObjectHelper, Equal) {
 }
 
 TEST(ObjectHelper, ToString) {
-    ObjectHelper* helper = GetObjectHelper<int>();
+    const ObjectHelper* helper = GetObjectHelper<int>();
     int i = 123456;
-    EXPECT_EQ(helper->to_string(&i), string("123456"));
+    string out = "i = ";
+    helper->append_to(out, &i);
+    EXPECT_EQ(out, string("i = 123456"));
 }
 
 TEST(ObjectHelper, Type) {
-    ObjectHelper* helper = GetObjectHelper<int>();
-    EXPECT_STREQ(helper->type()->name(), typeid(int).name());
+    const ObjectHelper* helper = GetObjectHelper<int>();
+    EXPECT_STREQ(helper->type->name(), typeid(int).name());
 }
 
 TEST(ObjectHelper, Arithmetic) {
-    ObjectHelper* helper = GetObjectHelper<int>();
+    const ObjectHelper* helper = GetObjectHelper<int>();
     int a = 100, b = 200;
     EXPECT_TRUE(helper->less(&a, &b));
     EXPECT_EQ(helper->sum(&a, &b).get<int>(), 300);
@@ -79,20 +148,20 @@ TEST(ObjectHelper, Arithmetic) {
 }
 
 TEST(ArrayHelper, AllocDealloc) {
-    ArrayHelper* helper = GetArrayHelper<int>();
+    const ArrayHelper* helper = GetArrayHelper<int>();
     TestAllocator<int>* allocator = static_cast<TestAllocator<int>*>(helper->get_allocator());
     void* ptr = helper->allocate(100);
     EXPECT_EQ(allocator->size_allocated, 100);
-    helper->destroy_deallocate(ptr, 100);
+    helper->destroy_deallocate(ptr, 100, 100);
     EXPECT_EQ(allocator->size_allocated, 0);
     allocator->reset();
 }
 
 TEST(ArrayHelper, ConstructDestruct) {
-    ArrayHelper* helper = GetArrayHelper<int>();
+    const ArrayHelper* helper = GetArrayHelper<int>();
     TestAllocator<int>* allocator = static_cast<TestAllocator<int>*>(helper->get_allocator());
     void* ptr = helper->allocate(100);
-    helper->construct(ptr, allocator->size_allocated);
+    helper->construct_default(ptr, allocator->size_allocated);
     int *it = static_cast<int*>(ptr), *const end = it + 100;
     while (it != end) {
         EXPECT_EQ(*it, 0);
@@ -101,13 +170,13 @@ TEST(ArrayHelper, ConstructDestruct) {
     int value = 123;
     helper->construct(ptr, &value);
     EXPECT_EQ(*static_cast<int*>(ptr), value);
-    helper->destroy_deallocate(ptr, 100);
+    helper->destroy_deallocate(ptr, 100, 100);
     EXPECT_EQ(allocator->size_allocated, 0);
     allocator->reset();
 }
 
 TEST(ArrayHelper, MakeCopy) {
-    ArrayHelper* helper = GetArrayHelper<int>();
+    const ArrayHelper* helper = GetArrayHelper<int>();
     int arr[100];
     for (int i = 0; i < 100; ++i) {
         arr[i] = i;
@@ -118,14 +187,34 @@ TEST(ArrayHelper, MakeCopy) {
     }
 }
 
+TEST(ArrayHelper, TrivialFastPaths) {
+    EXPECT_TRUE(IsZeroInitializable<double>::value);
+    EXPECT_TRUE(IsZeroInitializable<int*>::value);
+    EXPECT_FALSE(IsZeroInitializable<int LargeValue::*>::value); // null member pointer is not all zero
+    EXPECT_FALSE(IsZeroInitializable<string>::value);
+    const ArrayHelper* helper = GetArrayHelper<double>();
+    double arr[100];
+    std::memset(arr, 0xff, sizeof(arr));
+    helper->construct_default(arr, 100);
+    for (double d : arr) {
+        EXPECT_EQ(d, 0.0);
+    }
+    const ArrayHelper* str_helper = &ArrayHelperTable<string, std::allocator<string>>::value;
+    string strs[3] = {"a", "b", string(100, 'c')};
+    string* copied = static_cast<string*>(str_helper->make_partial_copy(strs, 5, 3));
+    EXPECT_EQ(copied[2], strs[2]);
+    EXPECT_TRUE(copied[4].empty());
+    str_helper->destroy_deallocate(copied, 5, 5);
+}
+
 TEST(ArrayHelper, Distance) {
-    ArrayHelper* helper = GetArrayHelper<int>();
+    const ArrayHelper* helper = GetArrayHelper<int>();
     int a, b;
     EXPECT_EQ(helper->distance(&a, &b), &a - &b);
 }
 
 TEST(ArrayHelper, Advance) {
-    ArrayHelper* helper = GetArrayHelper<int>();
+    const ArrayHelper* helper = GetArrayHelper<int>();
     int a;
     const int b{};
     EXPECT_EQ(helper->advance(&a, 100), &a + 100);
@@ -133,8 +222,187 @@ TEST(ArrayHelper, Advance) {
 }
 
 TEST(ArrayHelper, Type) {
-    ArrayHelper* helper = GetArrayHelper<int>();
-    EXPECT_STREQ(helper->type()->name(), typeid(int).name());
+    const ArrayHelper* helper = GetArrayHelper<int>();
+    EXPECT_STREQ(helper->type->name(), typeid(int).name());
+}
+
+TEST(TypeId, Identity) {
+    static_assert(type_id<int>() == type_id<const int&>(), "type id must ignore cv and reference");
+    EXPECT_NE(type_id<int>(), type_id<unsigned>());
+    EXPECT_NE(type_id<char>(), type_id<signed char>());
+    EXPECT_NE(type_id<std::vector<int>>(), type_id<std::vector<long>>());
+    EXPECT_EQ(GetObjectHelper<int>()->type_id, GetArrayHelper<int>()->type_id);
+}
+
+TEST(TypeId, Collision) {
+    // same id with another type_info, like same named types in anonymous namespaces of two TUs
+    ObjectHelper other = *GetObjectHelper<int>();
+    other.type = &typeid(long);
+    other.unique_type_id = false;
+    EXPECT_FALSE(same_type(&other, GetObjectHelper<int>()));
+    EXPECT_TRUE(same_type(GetObjectHelper<int>(), GetArrayHelper<int>()));
+    EXPECT_TRUE(has_type<const int&>(GetArrayHelper<int>()));
+    EXPECT_TRUE(has_type<std::nullptr_t>(static_cast<const ObjectHelper*>(nullptr)));
+    EXPECT_FALSE(same_type(GetObjectHelper<int>(), static_cast<const ArrayHelper*>(nullptr)));
+}
+
+namespace {
+    struct Unnamed {};
+}
+
+TEST(TypeId, UniqueName) {
+    struct Local {};
+    auto lambda = [] {};
+    static_assert(unique_type_id<int>() && unique_type_id<const std::vector<string>&>(), "");
+    static_assert(!unique_type_id<Unnamed>() && !unique_type_id<std::vector<Unnamed>>(), "");
+    static_assert(!unique_type_id<Local>() && !unique_type_id<decltype(lambda)>(), "");
+    EXPECT_FALSE(GetObjectHelper<Unnamed>()->unique_type_id);
+    EXPECT_TRUE(has_type<Unnamed>(GetObjectHelper<Unnamed>()));
+    EXPECT_FALSE(has_type<Local>(GetObjectHelper<Unnamed>()));
+}
+
+TEST(ObjectHelper, CompoundAssignment) {
+    const ObjectHelper* helper = GetObjectHelper<int>();
+    int a = 100, b = 7;
+    helper->sum_assign(&a, &b);
+    EXPECT_EQ(a, 107);
+    helper->difference_assign(&a, &b);
+    helper->product_assign(&a, &b);
+    EXPECT_EQ(a, 700);
+    helper->quotient_assign(&a, &b);
+    EXPECT_EQ(a, 100);
+}
+
+TEST(ObjectHelper, PromotionTable) {
+    EXPECT_EQ(GetObjectHelper<string>()->arith_index, 0);
+    EXPECT_EQ(promoted_ops(GetObjectHelper<int>(), GetObjectHelper<string>()), nullptr);
+    const PromotedOps* ops = promoted_ops(GetObjectHelper<int>(), GetObjectHelper<double>());
+    ASSERT_NE(ops, nullptr);
+    int a = 3;
+    double b = 0.5;
+    EXPECT_FALSE(ops->less(&a, &b));
+    EXPECT_TRUE(ops->sum(&a, &b).has_type<double>());
+    EXPECT_EQ(ops->product(&a, &b).get<double>(), 1.5);
+    EXPECT_EQ(less_function(GetObjectHelper<int>(), GetObjectHelper<int>()), GetObjectHelper<int>()->less);
+}
+
+TEST(ArrayHelper, EqualHash) {
+    const ArrayHelper* helper = GetArrayHelper<int>();
+    int a[100], b[100];
+    for (int i = 0; i < 100; ++i) {
+        a[i] = b[i] = i;
+    }
+    EXPECT_TRUE(helper->equal(a, b, 100));
+    // every length exercises a different mix of block, word and byte steps
+    for (size_t n = 0; n <= 100; ++n) {
+        EXPECT_EQ(helper->hash(a, n), helper->hash(b, n));
+    }
+    b[99] = 0;
+    EXPECT_FALSE(helper->equal(a, b, 100));
+    EXPECT_NE(helper->hash(a, 100), helper->hash(b, 100));
+    EXPECT_EQ(hash_bytes(a, 99 * sizeof(int)), hash_bytes(b, 99 * sizeof(int)));
+}
+
+TEST(HasStdHash, value) {
+    EXPECT_TRUE(HasStdHash<int>::value);
+    EXPECT_TRUE(HasStdHash<string>::value);
+    EXPECT_FALSE(HasStdHash<std::vector<int>>::value);
+    EXPECT_FALSE(HasStdHash<LargeValue>::value);
+}
+
+template <typename T>
+class ReallocAllocator {
+public:
+    size_t reallocated = 0;
+    T* allocate(size_t n) { return static_cast<T*>(std::malloc(n * sizeof(T))); }
+    void deallocate(T* p, size_t) { std::free(p); }
+    T* reallocate(T* p, size_t, size_t n) {
+        ++reallocated;
+        return static_cast<T*>(std::realloc(p, n * sizeof(T)));
+    }
+};
+
+TEST(ArrayHelper, Reallocate) {
+    static_assert(HasReallocate<ReallocAllocator<int>, int>::value, "realloc is used for trivially copyable types");
+    static_assert(!HasReallocate<ReallocAllocator<string>, string>::value, "realloc must not move non-trivial types");
+    static_assert(!HasReallocate<TestAllocator<int>, int>::value, "allocator without reallocate");
+    const ArrayHelper* helper = &ArrayHelperTable<int, ReallocAllocator<int>>::value;
+    auto* allocator = static_cast<ReallocAllocator<int>*>(helper->get_allocator());
+    int* ptr = static_cast<int*>(helper->reallocate(nullptr, 0, 0, 4));
+    for (int i = 0; i < 4; ++i) {
+        ptr[i] = i;
+    }
+    ptr = static_cast<int*>(helper->reallocate(ptr, 4, 4, 1000));
+    EXPECT_EQ(allocator->reallocated, 1);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(ptr[i], i);
+    }
+    helper->destroy_deallocate(ptr, 4, 1000);
+}
+
+template <class T>
+void ExpectSameOnEveryLevel(const std::vector<T>& v) {
+    simd::Level detected = simd::detected_level();
+    simd::set_level(simd::Level::scalar);
+    std::vector<T> w(v.rbegin(), v.rend()); // mixed signs in the products
+    // every length exercises a different split between vector body and scalar tail
+    for (size_t n = 1; n <= v.size(); n += 7) {
+        auto sum = simd::sum(v.data(), n);
+        auto minmax = simd::minmax(v.data(), n);
+        auto dot = simd::dot(v.data(), v.data(), n);
+        auto mixed_dot = simd::dot(v.data(), w.data(), n);
+        for (int level = 1; level <= static_cast<int>(detected); ++level) {
+            simd::set_level(static_cast<simd::Level>(level));
+            EXPECT_EQ(simd::sum(v.data(), n), sum) << "level " << level << ", n " << n;
+            EXPECT_EQ(simd::minmax(v.data(), n), minmax) << "level " << level << ", n " << n;
+            EXPECT_EQ(simd::dot(v.data(), v.data(), n), dot) << "level " << level << ", n " << n;
+            EXPECT_EQ(simd::dot(v.data(), w.data(), n), mixed_dot) << "level " << level << ", n " << n;
+        }
+        simd::set_level(simd::Level::scalar);
+    }
+    simd::set_level(detected);
+}
+
+TEST(Simd, BitIdenticalIntegers) {
+    std::vector<int> i32(300);
+    std::vector<long long> i64(300);
+    unsigned long long x = 88172645463325252ull;
+    for (size_t i = 0; i < i32.size(); ++i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17; // xorshift, values span the full range to force wrap-around
+        i32[i] = static_cast<int>(x);
+        i64[i] = static_cast<long long>(x);
+    }
+    ExpectSameOnEveryLevel(i32);
+    ExpectSameOnEveryLevel(i64);
+}
+
+TEST(Simd, FloatMinMax) {
+    std::vector<double> v(100);
+    for (size_t i = 0; i < v.size(); ++i) {
+        v[i] = (i % 2 ? -1.0 : 1.0) * static_cast<double>(i * 37 % 101);
+    }
+    auto expected = std::minmax_element(v.begin(), v.end());
+    for (int level = 0; level <= static_cast<int>(simd::detected_level()); ++level) {
+        simd::Level previous = simd::set_level(static_cast<simd::Level>(level));
+        EXPECT_EQ(simd::minmax(v.data(), v.size()), std::make_pair(*expected.first, *expected.second));
+        EXPECT_EQ(simd::sum(v.data(), v.size()), std::accumulate(v.begin(), v.end(), 0.0)); // exact, all integers
+        simd::set_level(previous);
+    }
+}
+
+TEST(ChunkLayout, CacheAligned) {
+    alignas(64) int data[1000];
+    for (size_t offset = 0; offset < 16; ++offset) {
+        ChunkLayout layout(data + offset, 1000 - offset, sizeof(int), 256);
+        EXPECT_EQ(layout.begin(0), 0);
+        EXPECT_EQ(layout.end(layout.count() - 1), 1000 - offset);
+        for (size_t chunk = 1; chunk < layout.count(); ++chunk) {
+            EXPECT_EQ(layout.begin(chunk), layout.end(chunk - 1));
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data + offset + layout.begin(chunk)) % CACHE_LINE_SIZE, 0);
+        }
+    }
+    EXPECT_EQ(ChunkLayout(data, 0, sizeof(int), 256).count(), 0);
+    EXPECT_EQ(ChunkLayout(data, 10, sizeof(int), 256).count(), 1);
 }
 
 struct EqualOperatorTester {
@@ -2,6 +2,10 @@
 #define OBJECT_TEST_H
 #include <gtest/gtest.h>
 #include <typeless.h>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
 
 using namespace typeless;
 
@@ -42,6 +46,46 @@ TEST(ObjectTest, Move) {
     EXPECT_EQ(move_to, 123);
 }
 
+TEST(ObjectTest, InlineStorage) {
+    Object i(123), d(1.5);
+    Object str{string(100, 'A')};
+    EXPECT_TRUE(i.is_inline());
+    EXPECT_TRUE(d.is_inline());
+    EXPECT_EQ(i.data(), &i.storage_);
+    Object moved_i = std::move(i), moved_str = std::move(str);
+    EXPECT_TRUE(moved_i.is_inline());
+    EXPECT_EQ(moved_i.data(), &moved_i.storage_);
+    EXPECT_EQ(moved_i, 123);
+    EXPECT_EQ(moved_str, string(100, 'A'));
+    moved_i.swap(d);
+    EXPECT_EQ(moved_i, 1.5);
+    EXPECT_EQ(d, 123);
+    EXPECT_EQ(d.data(), &d.storage_);
+}
+
+TEST(ObjectTest, MoveValue) {
+    string str(100, 'A');
+    const char* buffer = str.data();
+    Object obj(std::move(str));
+    EXPECT_EQ(obj.get<string>().data(), buffer); // buffer is moved, not copied
+    std::vector<int> v{1, 2, 3};
+    obj.set(std::move(v));
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(obj.get<std::vector<int>>().size(), 3);
+}
+
+TEST(ObjectTest, Emplace) {
+    Object obj(in_place_type<string>, 5, 'A');
+    EXPECT_EQ(obj, string("AAAAA"));
+    auto& v = obj.emplace<std::vector<int>>(3, 7);
+    EXPECT_TRUE(obj.has_type<std::vector<int>>());
+    EXPECT_EQ(&v, obj.data());
+    EXPECT_EQ(v, std::vector<int>({7, 7, 7}));
+    obj.emplace<int>(123);
+    EXPECT_TRUE(obj.is_inline());
+    EXPECT_EQ(obj, 123);
+}
+
 TEST(ObjectTest, Type) {
     Object str_obj{string("Hello World!")};
     Object float_obj{123.f};
@@ -49,6 +93,17 @@ TEST(ObjectTest, Type) {
     EXPECT_EQ(float_obj.type(), typeid(float));
 }
 
+TEST(ObjectTest, HasType) {
+    Object obj(123), empty;
+    EXPECT_TRUE(obj.has_type<int>());
+    EXPECT_TRUE(obj.has_type<const int>());
+    EXPECT_FALSE(obj.has_type<unsigned>());
+    EXPECT_FALSE(obj.has_type<long>());
+    EXPECT_TRUE(empty.has_type<std::nullptr_t>());
+    EXPECT_EQ(obj.type_id(), Object(456).type_id());
+    EXPECT_NE(obj.type_id(), Object(456.0).type_id());
+}
+
 TEST(ObjectTest, ValueValidity) {
     Object str_vector(std::vector<int>{0, 1, 2, 3, 4, 5, 6});
     Object clone = str_vector.clone();
@@ -73,6 +128,53 @@ TEST(ObjectTest, Set) {
     EXPECT_EQ(obj.get<string>(), "AAAAA");
 }
 
+TEST(ObjectTest, SetReusesStorage) {
+    Object obj(string(100, 'A'));
+    const void* storage = obj.data();
+    EXPECT_TRUE(obj.set(string(100, 'B')));
+    EXPECT_EQ(obj.data(), storage);
+    EXPECT_EQ(obj, string(100, 'B'));
+    EXPECT_FALSE(obj.set(123));
+    EXPECT_TRUE(obj.set(456));
+    EXPECT_EQ(obj, 456);
+}
+
+struct NotAssignable {
+    const int value;
+};
+
+TEST(ObjectTest, AssignReusesStorage) {
+    Object obj(string(100, 'A')), other(string(100, 'B'));
+    const void* storage = obj.data();
+    EXPECT_TRUE(obj.assign(other));
+    EXPECT_EQ(obj.data(), storage);
+    EXPECT_EQ(obj, string(100, 'B'));
+    obj = Object(1.5);
+    EXPECT_EQ(obj, 1.5);
+    Object not_assignable(NotAssignable{1});
+    EXPECT_FALSE(not_assignable.assign(Object(NotAssignable{2})));
+    EXPECT_EQ(not_assignable.get<NotAssignable>().value, 2);
+    EXPECT_FALSE(not_assignable.set(NotAssignable{3}));
+    EXPECT_EQ(not_assignable.get<NotAssignable>().value, 3);
+}
+
+struct CopyThrows {
+    CopyThrows() = default;
+    CopyThrows(CopyThrows&&) = default;
+    CopyThrows(const CopyThrows&) { throw std::runtime_error("copy"); }
+};
+
+TEST(ObjectTest, AssignThrowingCopy) {
+    Object obj(string(100, 'A'));
+    Object throwing{CopyThrows{}};
+    EXPECT_THROW(obj.assign(throwing), std::runtime_error);
+    EXPECT_TRUE(obj.empty()); // left empty, still safe to destroy
+    EXPECT_THROW(obj = throwing, std::runtime_error);
+    EXPECT_TRUE(obj.empty());
+    obj = 1;
+    EXPECT_EQ(obj, 1);
+}
+
 TEST(ObjectTest, Swapping) {
     Object str_obj{string("Hello World!")};
     Object int_obj{123};
@@ -104,6 +206,92 @@ TEST(ObjectTest, Arithmetic) {
     EXPECT_TRUE(i2 >= i1);
 }
 
+TEST(ObjectTest, MixedArithmetic) {
+    Object i = 1, d = 2.5, c = 'a', u = 1u, f = 0.5f;
+    EXPECT_EQ(i + d, 3.5);
+    EXPECT_EQ(d - i, 1.5);
+    EXPECT_EQ(i * f, 0.5f);
+    EXPECT_EQ(d / f, 5.0);
+    EXPECT_EQ(c + i, 98); // char + int is int
+    EXPECT_TRUE((c + i).has_type<int>());
+    EXPECT_TRUE((Object(2L) * i).has_type<long>());
+    EXPECT_TRUE(i < d);
+    EXPECT_TRUE(d > i);
+    EXPECT_TRUE(i <= u);
+    EXPECT_TRUE(i >= u);
+    EXPECT_TRUE(Object(-1) < u); // compared by value, -1 is not converted to unsigned
+    EXPECT_FALSE(Object(-1) == Object(~0u));
+    EXPECT_TRUE((i + Object(string("x"))).empty());
+    EXPECT_FALSE(i < Object(string("x")));
+    EXPECT_FALSE(i <= Object(string("x")));
+    EXPECT_FALSE(i > i);
+    EXPECT_TRUE(i >= i);
+}
+
+TEST(ObjectTest, MixedComparisonTrichotomy) {
+    const Object values[] = {Object(-1), Object(1), Object(1.0), Object(1.5), Object(2u), Object(2.0f), Object('a')};
+    for (const Object& l : values) {
+        for (const Object& r : values) {
+            int holds = (l < r) + (l == r) + (l > r);
+            EXPECT_EQ(holds, 1) << l.to_string() << " vs " << r.to_string();
+            EXPECT_EQ(l <= r, l < r || l == r) << l.to_string() << " vs " << r.to_string();
+            EXPECT_EQ(l >= r, l > r || l == r) << l.to_string() << " vs " << r.to_string();
+            EXPECT_EQ(l != r, !(l == r)) << l.to_string() << " vs " << r.to_string();
+            if (l == r) {
+                EXPECT_EQ(std::hash<Object>()(l), std::hash<Object>()(r)) << l.to_string() << " vs " << r.to_string();
+            }
+        }
+    }
+    EXPECT_TRUE(Object(1) == Object(1.0));
+    EXPECT_TRUE(Object(97) == Object('a'));
+    EXPECT_FALSE(Object(1) == Object(string("1")));
+    const Object nan(std::numeric_limits<double>::quiet_NaN());
+    const Object others[] = {nan, Object(1.0), Object(1), Object(1.0f)};
+    for (const Object& other : others) { // NaN is unordered with everything, itself included
+        EXPECT_FALSE(nan < other) << other.to_string();
+        EXPECT_FALSE(nan <= other) << other.to_string();
+        EXPECT_FALSE(nan >= other) << other.to_string();
+        EXPECT_FALSE(other <= nan) << other.to_string();
+        EXPECT_FALSE(other >= nan) << other.to_string();
+        EXPECT_FALSE(nan == other) << other.to_string();
+    }
+}
+
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__) // __int128 is not arithmetic under -std=c++NN
+TEST(ObjectTest, UnlistedArithmeticType) {
+    Object big = static_cast<__int128>(5); // arithmetic under gnu++, but not promoted
+    EXPECT_TRUE((big + big).has_type<__int128>());
+    EXPECT_TRUE(big < Object(static_cast<__int128>(6)));
+    EXPECT_FALSE(big == Object(5));
+    EXPECT_TRUE((big + Object(1)).empty());
+}
+#endif
+
+TEST(ObjectTest, CompoundAssignment) {
+    Object acc = 0;
+    const void* storage = acc.data();
+    for (int i = 1; i <= 10; ++i) {
+        acc += i;
+    }
+    EXPECT_EQ(acc, 55);
+    acc -= 5;
+    EXPECT_EQ(acc, 50);
+    acc *= 2;
+    EXPECT_EQ(acc, 100);
+    acc /= 3;
+    EXPECT_EQ(acc, 33);
+    acc += 0.9; // keeps int like built-in compound assignment
+    EXPECT_EQ(acc, 33);
+    EXPECT_EQ(acc.data(), storage);
+    Object d = 1.5;
+    d *= Object(2);
+    EXPECT_EQ(d, 3.0);
+    acc += Object(string("x"));
+    EXPECT_TRUE(acc.empty());
+    Object str = string("");
+    EXPECT_ANY_THROW(str += str);
+}
+
 TEST(ObjectTest, ArithmeticOp_On_NonArithmetic_Type) {
     Object obj1, obj2;
     obj1 = obj2 = string("");
@@ -117,11 +305,28 @@ TEST(ObjectTest, ArithmeticOp_On_NonArithmetic_Type) {
     EXPECT_ANY_THROW(obj1 >= obj2);
 }
 
+TEST(ObjectTest, Hash) {
+    std::hash<Object> hasher;
+    EXPECT_EQ(hasher(Object(123)), hasher(Object(123)));
+    EXPECT_EQ(hasher(Object(string("foo"))), hasher(Object(string("foo"))));
+    EXPECT_NE(hasher(Object(123)), hasher(Object(456)));
+    EXPECT_EQ(hasher(Object()), 0);
+    std::unordered_set<Object> set{123, 456, string("foo"), 123, string("foo"), 1.5};
+    EXPECT_EQ(set.size(), 4);
+    EXPECT_EQ(set.count(string("foo")), 1);
+    EXPECT_EQ(set.count(123), 1);
+    EXPECT_EQ(set.count(123L), 1); // arithmetic values of different types compare equal
+    EXPECT_EQ(set.count(123.0), 1);
+    EXPECT_EQ(set.count(string("123")), 0);
+}
+
 TEST(ObjectTest, ToString) {
     Object obj(123456789);
     EXPECT_EQ(obj.to_string(), "123456789");
     obj = 456789.0;
-    EXPECT_EQ(obj.to_string(), "456789.000000");
+    EXPECT_EQ(obj.to_string(), "456789");
+    obj = 0.1;
+    EXPECT_EQ(obj.to_string(), "0.1");
     obj = string("Hello World!");
     EXPECT_EQ(obj.to_string(), "Hello World!");
     obj = (const char*)"C-Style string";
@@ -130,5 +335,57 @@ TEST(ObjectTest, ToString) {
     EXPECT_EQ(obj.to_string(), typeid(std::vector<int>).name());
     obj = 'A';
     EXPECT_EQ(obj.to_string(), "A");
+    obj = true;
+    EXPECT_EQ(obj.to_string(), "1");
+}
+
+TEST(ObjectTest, AppendTo) {
+    string out = "values:";
+    for (const Object& obj : {Object(-42), Object(2.5f), Object(string(" str ")), Object()}) {
+        obj.append_to(out);
+    }
+    EXPECT_EQ(out, "values:-422.5 str null");
+    std::ostringstream os;
+    os << Object(7u) << ',' << Object(1e21);
+    EXPECT_EQ(os.str(), "7,1e+21");
+}
+
+TEST(SharedObjectTest, CopyShares) {
+    const SharedObject obj(string(100, 'A'));
+    const SharedObject copy(obj);
+    EXPECT_EQ(obj.use_count(), 2);
+    EXPECT_EQ(&obj.get<string>(), &copy.get<string>()); // same payload, no copy
+    EXPECT_EQ(obj.block_, copy.block_);
+    SharedObject assigned;
+    assigned = copy;
+    EXPECT_EQ(obj.use_count(), 3);
+    assigned.reset();
+    EXPECT_TRUE(assigned.empty());
+    EXPECT_EQ(obj.use_count(), 2);
+}
+
+TEST(SharedObjectTest, CopyOnWrite) {
+    SharedObject obj(string("foo"));
+    SharedObject copy(obj);
+    const string& before = static_cast<const SharedObject&>(obj).get<string>();
+    copy.get<string>() += "bar";
+    EXPECT_NE(obj.block_, copy.block_);
+    EXPECT_EQ(&before, &static_cast<const SharedObject&>(obj).get<string>());
+    EXPECT_EQ(before, "foo");
+    EXPECT_EQ(copy.object(), string("foobar"));
+    EXPECT_TRUE(obj.unique());
+    EXPECT_TRUE(copy.unique());
+    string& private_value = copy.get<string>(); // unique, no copy
+    EXPECT_EQ(&private_value, &copy.get<string>());
+}
+
+TEST(SharedObjectTest, FromObject) {
+    Object obj(123);
+    SharedObject shared(obj);
+    EXPECT_TRUE(shared.has_type<int>());
+    EXPECT_EQ(shared.object(), 123);
+    EXPECT_EQ(shared.to_string(), "123");
+    EXPECT_TRUE(SharedObject(Object()).empty());
+    EXPECT_TRUE(SharedObject().object().empty());
 }
-#endif
\ No newline at end of file
+#endif
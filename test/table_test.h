@@ -0,0 +1,87 @@
+#ifndef TABLE_TEST_H
+#define TABLE_TEST_H
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <typeless.h>
+
+using namespace typeless;
+
+TEST(TableTest, Columns) {
+    Table table;
+    table.add_column<int>("id", Array{1, 2, 3});
+    table.add_column<double>("price", Array{2.5, 1.0, 4.0});
+    table.add_column<string>("name");
+    EXPECT_EQ(table.rows(), 3);
+    EXPECT_EQ(table.columns(), 3);
+    EXPECT_EQ(table.column_name(1), "price");
+    EXPECT_EQ(table.column_index("name"), 2);
+    EXPECT_TRUE(table.has_column("id"));
+    EXPECT_FALSE(table.has_column("qty"));
+    EXPECT_EQ(table.column("name").at<string>(2), ""); // value initialized for existing rows
+    EXPECT_EQ(table.column("price").sum<double>(), 7.5);
+    EXPECT_EQ(table.column(0).max<int>(), 3);
+    for (double& price : table.span<double>("price")) {
+        price *= 2;
+    }
+    EXPECT_EQ(table.column("price").sum<double>(), 15.0);
+    EXPECT_THROW(table.add_column<int>("id"), std::invalid_argument);
+    EXPECT_THROW(table.add_column<int>("qty", Array{1}), std::invalid_argument);
+    EXPECT_THROW(table.add_column<int>("qty", Array{1.0, 2.0, 3.0}), std::bad_cast);
+    EXPECT_THROW(table.column("qty"), std::out_of_range);
+}
+
+TEST(TableTest, Rows) {
+    Table table;
+    table.add_column<int>("id");
+    table.add_column<string>("name");
+    table.reserve(2);
+    table.append_row({1, string("apple")});
+    table.append_row({2, string("fig")});
+    EXPECT_EQ(table.rows(), 2);
+    TableRow row = table.row(1);
+    EXPECT_EQ(row.index(), 1);
+    EXPECT_EQ(row.size(), 2);
+    EXPECT_EQ(row.get<string>("name"), "fig");
+    EXPECT_EQ(row[0].get<int>(), 2);
+    EXPECT_EQ(row["name"].to_string(), "fig");
+    Array objects = row.to_array();
+    EXPECT_EQ(objects.at<Object>(0).get<int>(), 2);
+    EXPECT_EQ(objects.at<Object>(1).get<string>(), "fig");
+    EXPECT_EQ(table.column("id").sum<int>(), 3);
+    EXPECT_THROW(table.append_row({3}), std::invalid_argument);
+    EXPECT_THROW(table.append_row({string("x"), 3}), std::bad_cast);
+    EXPECT_EQ(table.rows(), 2);
+    EXPECT_EQ(table.column("name").size(), 2);
+    ArrayView names = table.column("name").slice(0, 2);
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.columns(), 2);
+    EXPECT_EQ(names.at<string>(1), "fig"); // shared buffer is released, not copied
+    EXPECT_EQ(table.column("name").size(), 0);
+    EXPECT_GE(table.column("id").capacity(), 2);
+    table.append_row({3, string("kiwi")});
+    EXPECT_EQ(table.row(0).get<string>("name"), "kiwi");
+}
+
+struct CopyCounter {
+    static int copies_left;
+    CopyCounter() = default;
+    CopyCounter(const CopyCounter&) {
+        if (copies_left-- == 0)
+            throw std::runtime_error("copy");
+    }
+    CopyCounter& operator=(const CopyCounter&) = default;
+};
+int CopyCounter::copies_left = 0;
+
+TEST(TableTest, AppendRowRollback) {
+    Table table;
+    table.add_column<string>("name");
+    table.add_column<CopyCounter>("counter");
+    CopyCounter::copies_left = 1; // copy into the Object succeeds, copy into the column throws
+    EXPECT_THROW(table.append_row({string("a"), CopyCounter()}), std::runtime_error);
+    EXPECT_EQ(table.rows(), 0);
+    EXPECT_EQ(table.column("name").size(), 0);
+    EXPECT_EQ(table.column("counter").size(), 0);
+}
+#endif
@@ -1,2 +1,7 @@
 #include "object_test.h"
-#include "array_test.h"
\ No newline at end of file
+#include "array_test.h"
+#include "thread_pool_test.h"
+#include "typed_array_test.h"
+#include "variant_array_test.h"
+#include "table_test.h"
+#include "array_view_test.h"
\ No newline at end of file
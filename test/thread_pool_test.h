@@ -0,0 +1,121 @@
+#ifndef THREAD_POOL_TEST_H
+#define THREAD_POOL_TEST_H
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <typeless.h>
+
+using namespace typeless;
+
+TEST(ThreadPoolTest, ParallelFor) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallel_for(hits.size(), [&](size_t i) { ++hits[i]; });
+    for (auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+    pool.parallel_for(0, [](size_t) { FAIL(); });
+}
+
+TEST(ThreadPoolTest, Nested) {
+    ThreadPool pool(3);
+    std::atomic<int> count{0};
+    pool.parallel_for(8, [&](size_t) { pool.parallel_for(8, [&](size_t) { ++count; }); });
+    EXPECT_EQ(count.load(), 64);
+}
+
+TEST(ThreadPoolTest, Exception) {
+    ThreadPool pool(4);
+    EXPECT_THROW(pool.parallel_for(100,
+                                   [](size_t i) {
+                                       if (i == 42)
+                                           throw std::runtime_error("failed");
+                                   }),
+                 std::runtime_error);
+    std::atomic<int> count{0};
+    pool.parallel_for(10, [&](size_t) { ++count; }); // pool is still usable
+    EXPECT_EQ(count.load(), 10);
+}
+
+TEST(ThreadPoolTest, ParallelChunks) {
+    ThreadPool pool(4);
+    pool.set_chunk_size(256);
+    std::vector<int> v(10001);
+    pool.parallel_chunks(v.data(), v.size(), [](int* first, int* last) {
+        for (; first != last; ++first) {
+            ++*first;
+        }
+    });
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 10001);
+}
+
+TEST(ThreadPoolTest, ParallelArrayAlgorithms) {
+    ThreadPool pool(4);
+    pool.set_chunk_size(128); // many small chunks
+    std::vector<int> v(5000);
+    for (size_t i = 0; i < v.size(); ++i) {
+        v[i] = static_cast<int>((i * 7919) % 5003);
+    }
+    Array arr(v.begin(), v.end());
+    std::atomic<long long> sum{0};
+    arr.for_each<int>(pool, [&](int i) { sum += i; });
+    EXPECT_EQ(sum.load(), arr.sum<int>());
+    auto is_even = [](int i) { return i % 2 == 0; };
+    EXPECT_EQ(arr.filter<int>(pool, is_even), arr.filter<int>(is_even));
+    auto add = [](long long acc, long long i) { return acc + i; };
+    EXPECT_EQ(arr.reduce<int>(pool, 0LL, add), arr.sum<int>());
+    Array transformed = arr;
+    transformed.transform<int>(pool, [](int i) { return i * 2; });
+    arr.transform<int>([](int i) { return i * 2; });
+    EXPECT_EQ(transformed, arr);
+    arr.sort<int>(pool);
+    std::sort(v.begin(), v.end());
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(arr.at<int>(i), v[i] * 2);
+    }
+}
+
+TEST(ThreadPoolTest, ParallelStrings) {
+    ThreadPool pool(4);
+    pool.set_chunk_size(64);
+    std::vector<string> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.push_back(std::to_string((i * 31) % 3000));
+    }
+    Array arr(v.begin(), v.end());
+    auto concat = [](string acc, const string& s) {
+        acc += s;
+        return acc;
+    };
+    EXPECT_EQ(arr.reduce<string>(pool, string(), concat), arr.reduce<string>(string(), concat));
+    auto has_7 = [](const string& s) { return s.find('7') != string::npos; };
+    EXPECT_EQ(arr.filter<string>(pool, has_7), arr.filter<string>(has_7));
+    auto size_of = [](const string& s) { return s.size(); };
+    EXPECT_EQ(arr.map<string>(pool, size_of), arr.map<string>(size_of));
+    arr.sort<string>(pool, std::greater<string>());
+    std::sort(v.begin(), v.end(), std::greater<string>());
+    EXPECT_EQ(arr, Array(v.begin(), v.end()));
+}
+TEST(ThreadPoolTest, CopyOnWriteCopies) {
+    ThreadPool pool(4);
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+    Array arr(values.begin(), values.end());
+    arr.set_copy_on_write(true);
+    std::vector<long long> sums(64);
+    pool.parallel_for(sums.size(), [&](size_t i) {
+        Array copy = arr; // shares the buffer
+        if (i % 2 == 0) {
+            copy.at<int>(0) = 1; // detaches only this copy
+        }
+        sums[i] = copy.sum<int>();
+    });
+    long long total = std::accumulate(values.begin(), values.end(), 0LL);
+    for (size_t i = 0; i < sums.size(); ++i) {
+        EXPECT_EQ(sums[i], i % 2 == 0 ? total + 1 : total);
+    }
+    EXPECT_EQ(arr.use_count(), 1);
+}
+#endif
@@ -0,0 +1,80 @@
+#ifndef TYPED_ARRAY_TEST_H
+#define TYPED_ARRAY_TEST_H
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <typeinfo>
+#include <typeless.h>
+
+using namespace typeless;
+
+TEST(TypedArrayTest, Initialization) {
+    TypedArray<int> arr{1, 2, 3, 4};
+    EXPECT_EQ(arr.size(), 4);
+    EXPECT_EQ(std::accumulate(arr.begin(), arr.end(), 0), 10);
+    TypedArray<string> strs;
+    EXPECT_TRUE(strs.empty());
+    EXPECT_TRUE(strs.array().has_type<string>());
+    strs.push_back("foo");
+    strs.emplace_back(3, 'x');
+    EXPECT_EQ(strs.front(), "foo");
+    EXPECT_EQ(strs.back(), "xxx");
+    std::vector<double> v{0.5, 1.5};
+    TypedArray<double> doubles(v.begin(), v.end());
+    EXPECT_EQ(doubles, (TypedArray<double>{0.5, 1.5}));
+}
+
+TEST(TypedArrayTest, Conversion) {
+    Array arr{3, 1, 2};
+    const int* storage = arr.data<int>();
+    TypedArray<int> typed(std::move(arr));
+    EXPECT_EQ(typed.data(), storage); // storage is taken over, not copied
+    std::sort(typed.begin(), typed.end());
+    Array back = typed.release();
+    EXPECT_EQ(back.data<int>(), storage);
+    EXPECT_EQ(back, (Array{1, 2, 3}));
+    EXPECT_TRUE(typed.empty());
+    typed.push_back(4); // still typed after release
+    EXPECT_EQ(typed[0], 4);
+    EXPECT_THROW(TypedArray<double>(Array{1, 2}), std::bad_cast);
+    EXPECT_TRUE(TypedArray<double>(Array()).empty());
+}
+
+TEST(TypedArrayTest, Capacity) {
+    TypedArray<int> arr;
+    arr.reserve(10);
+    EXPECT_GE(arr.capacity(), 10);
+    arr.resize(3);
+    EXPECT_EQ(arr, (TypedArray<int>{0, 0, 0}));
+    arr.shrink_to_fit();
+    EXPECT_EQ(arr.capacity(), 3);
+    TypedArray<int> other{7};
+    arr.swap(other);
+    EXPECT_EQ(arr.size(), 1);
+    EXPECT_EQ(other.size(), 3);
+}
+
+TEST(ArraySpanTest, View) {
+    Array arr{1, 2, 3, 4, 5};
+    ArraySpan<int> span(arr);
+    EXPECT_EQ(span.size(), 5);
+    EXPECT_EQ(span.data(), arr.data<int>());
+    std::fill(span.begin(), span.begin() + 2, 0);
+    EXPECT_EQ(arr, (Array{0, 0, 3, 4, 5}));
+    ArraySpan<const int> tail = span.subspan(2);
+    EXPECT_EQ(std::accumulate(tail.begin(), tail.end(), 0), 12);
+    EXPECT_EQ(span.first(2).size(), 2);
+    EXPECT_EQ(span.last(1).front(), 5);
+    EXPECT_EQ(span.subspan(1, 3).back(), 4);
+    const Array& const_arr = arr;
+    ArraySpan<const int> const_span(const_arr);
+    EXPECT_EQ(const_span[4], 5);
+    EXPECT_THROW(ArraySpan<float>{arr}, std::bad_cast);
+    Array untyped;
+    EXPECT_TRUE(ArraySpan<int>(untyped).empty());
+    TypedArray<int> typed{1, 2};
+    ArraySpan<int> typed_span = typed;
+    typed_span[1] = 7;
+    EXPECT_EQ(typed[1], 7);
+}
+#endif
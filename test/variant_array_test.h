@@ -0,0 +1,89 @@
+#ifndef VARIANT_ARRAY_TEST_H
+#define VARIANT_ARRAY_TEST_H
+#include <array>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <typeless.h>
+
+using namespace typeless;
+
+TEST(VariantArrayTest, Initialization) {
+    VariantArray arr{123, '+', 456, string(" = "), 579.5};
+    EXPECT_EQ(arr.size(), 5);
+    EXPECT_TRUE(arr.has_type<int>(0));
+    EXPECT_TRUE(arr.has_type<char>(1));
+    EXPECT_TRUE(arr.has_type<string>(3));
+    EXPECT_EQ(arr.type(4), typeid(double));
+    EXPECT_EQ(arr.get<int>(2), 456);
+    EXPECT_EQ(arr.get<string>(3), " = ");
+    EXPECT_EQ(arr[4].get<double>(), 579.5);
+    string printed;
+    arr.visit([&](VariantRef ref) { ref.append_to(printed); });
+    EXPECT_EQ(printed, "123+456 = 579.5");
+}
+
+TEST(VariantArrayTest, LargeValues) {
+    using Block = std::array<int, 64>;
+    VariantArray arr;
+    Block block{};
+    for (int i = 0; i < 200; ++i) { // spans several arena chunks
+        block[0] = i;
+        arr.push_back(block);
+        arr.push_back(string(100, static_cast<char>('a' + i % 26)));
+        arr.push_back(i);
+    }
+    EXPECT_EQ(arr.size(), 600);
+    EXPECT_EQ(arr.get<Block>(3 * 150)[0], 150);
+    EXPECT_EQ(arr.get<string>(3 * 27 + 1), string(100, 'b'));
+    VariantArray copy = arr;
+    arr.clear();
+    EXPECT_TRUE(arr.empty());
+    EXPECT_EQ(copy.get<Block>(3 * 199)[0], 199);
+    VariantArray moved = std::move(copy);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(moved.get<int>(3 * 199 + 2), 199);
+}
+
+TEST(VariantArrayTest, GroupedDispatch) {
+    VariantArray arr{1, string("a"), 2, 0.5, 3, string("b")};
+    int total = 0;
+    arr.for_each<int>([&](int v) { total += v; });
+    EXPECT_EQ(total, 6);
+    string joined;
+    arr.for_each<string>([&](const string& s) { joined += s; });
+    EXPECT_EQ(joined, "ab");
+    EXPECT_EQ(arr.count<int>(), 3);
+    EXPECT_EQ(arr.count<double>(), 1);
+    EXPECT_EQ(arr.count<float>(), 0);
+    arr.for_each<float>([](float) { FAIL(); });
+}
+
+TEST(VariantArrayTest, Conversion) {
+    Array objects = ObjectArray{1, string("two"), 3.0};
+    VariantArray packed(objects);
+    EXPECT_EQ(packed.get<string>(1), "two");
+    Array unpacked = packed.to_array();
+    EXPECT_EQ(unpacked.size(), 3);
+    EXPECT_EQ(unpacked.at<Object>(0).get<int>(), 1);
+    EXPECT_EQ(unpacked.at<Object>(1).get<string>(), "two");
+    EXPECT_EQ(unpacked.at<Object>(2).get<double>(), 3.0);
+    EXPECT_EQ(packed.at(1).to_string(), "two");
+}
+
+struct ThrowOnCopy {
+    ThrowOnCopy() = default;
+    ThrowOnCopy(const ThrowOnCopy&) { throw std::runtime_error("copy"); }
+    ThrowOnCopy& operator=(const ThrowOnCopy&) = default;
+    std::array<char, 32> payload{};
+};
+
+TEST(VariantArrayTest, ExceptionSafety) {
+    VariantArray arr{1, 2};
+    ThrowOnCopy value;
+    EXPECT_THROW(arr.push_back(value), std::runtime_error);
+    EXPECT_EQ(arr.size(), 2);
+    EXPECT_EQ(arr.get<int>(1), 2);
+    EXPECT_THROW(arr.push_back(Object()), std::invalid_argument);
+    EXPECT_EQ(arr.size(), 2);
+}
+#endif